@@ -1,20 +1,274 @@
 #include <Math.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <future>
 #include <iostream>
-#include <typeinfo>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace math;
 using calculus::details::_high_order_dual_number;
 
-int main([[maybe_unused]] int argc,
-         [[maybe_unused]] char **argv)
+// evaluates a function and its derivatives up to a given order at every point of a binary file of doubles
+// usage: Application <function> <order> <input> <output> [--csv] [--threads n]
+
+static constexpr size_type max_order = 15;
+static constexpr size_type chunk_points = 1u << 16;
+
+// the Taylor number is sized to the requested order, so low orders do not pay for the full recurrences
+template <size_type order>
+using taylor_type = _high_order_dual_number<double, order + 1>;
+
+// values[p * (order + 1) + i] = f^(i)(points[p]) for begin <= p < end
+typedef std::function<void(const double *, double *, size_type, size_type)> kernel_type;
+typedef std::array<kernel_type, max_order + 1> kernel_set;
+
+template <size_type order, typename function_type>
+static void evaluate_points(const function_type &function, const double *points, double *values,
+                            size_type begin, size_type end)
+{
+    for (size_type p = begin; p < end; ++p)
+    {
+        taylor_type<order> f = function(taylor_type<order>{points[p]});
+        for (size_type i = 0; i <= order; ++i)
+            values[p * (order + 1) + i] = f.derivative(i);
+    }
+}
+
+template <typename function_type, size_type... orders>
+static kernel_set make_kernels(const function_type &function, std::integer_sequence<size_type, orders...>)
+{
+    return kernel_set{{[function](const double *points, double *values, size_type begin, size_type end)
+                       { evaluate_points<orders>(function, points, values, begin, end); }...}};
+}
+
+static std::map<std::string, kernel_set> &function_registry()
+{
+    typedef std::make_integer_sequence<size_type, max_order + 1> all_orders;
+    static std::map<std::string, kernel_set> registry{
+        {"sin", make_kernels([](const auto &x) { return sin(x); }, all_orders{})},
+        {"cos", make_kernels([](const auto &x) { return cos(x); }, all_orders{})},
+        {"tan", make_kernels([](const auto &x) { return tan(x); }, all_orders{})},
+        {"cot", make_kernels([](const auto &x) { return cot(x); }, all_orders{})},
+        {"sec", make_kernels([](const auto &x) { return sec(x); }, all_orders{})},
+        {"csc", make_kernels([](const auto &x) { return csc(x); }, all_orders{})}};
+    return registry;
+}
+
+// functions registered here are selectable by name like the built-in ones,
+// function is called with _high_order_dual_number<double, order + 1> for every order up to max_order
+template <typename function_type>
+void register_function(const std::string &name, const function_type &function)
+{
+    function_registry()[name] = make_kernels(function, std::make_integer_sequence<size_type, max_order + 1>{});
+}
+
+// decimal digits only, anything else is rejected instead of read as 0
+static size_type parse_size(const char *text, const char *what)
+{
+    char *end = nullptr;
+    errno = 0;
+    unsigned long value = std::strtoul(text, &end, 10);
+    if (!std::isdigit(static_cast<unsigned char>(text[0])) || *end != '\0' || errno == ERANGE ||
+        value > std::numeric_limits<size_type>::max())
+        throw std::runtime_error(std::string{"invalid "} + what + " " + text);
+    return static_cast<size_type>(value);
+}
+
+// read-only view of a whole file, the points are used in place
+class mapped_file
 {
-    _high_order_dual_number<double, 6> x{0.2758};
-    auto f = sec(x);
-    std::cout << f.derivative(0) << '\n';
-    std::cout << f.derivative(1) << '\n';
-    std::cout << f.derivative(2) << '\n';
-    std::cout << f.derivative(3) << '\n';
+public:
+    explicit mapped_file(const char *path)
+    {
+        _fd = ::open(path, O_RDONLY);
+        if (_fd < 0)
+            throw std::runtime_error(std::string{"cannot open "} + path + ": " + std::strerror(errno));
+        struct stat info;
+        if (::fstat(_fd, &info) != 0)
+            throw std::runtime_error(std::string{"cannot stat "} + path + ": " + std::strerror(errno));
+        _size = static_cast<std::size_t>(info.st_size);
+        if (_size == 0)
+            return;
+        _data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+        if (_data == MAP_FAILED)
+            throw std::runtime_error(std::string{"cannot map "} + path + ": " + std::strerror(errno));
+        ::madvise(_data, _size, MADV_SEQUENTIAL);
+    }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    ~mapped_file()
+    {
+        if (_data != nullptr && _data != MAP_FAILED)
+            ::munmap(_data, _size);
+        if (_fd >= 0)
+            ::close(_fd);
+    }
+
+    const void *data() const noexcept { return _data; }
+    std::size_t size() const noexcept { return _size; }
+
+private:
+    int _fd = -1;
+    void *_data = nullptr;
+    std::size_t _size = 0;
+};
+
+class output_file
+{
+public:
+    explicit output_file(const char *path)
+    {
+        _fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (_fd < 0)
+            throw std::runtime_error(std::string{"cannot open "} + path + ": " + std::strerror(errno));
+    }
+
+    output_file(const output_file &) = delete;
+    output_file &operator=(const output_file &) = delete;
+
+    ~output_file()
+    {
+        if (_fd >= 0)
+            ::close(_fd);
+    }
+
+    void write(const char *data, std::size_t size)
+    {
+        while (size != 0)
+        {
+            ssize_t written = ::write(_fd, data, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error(std::string{"write failed: "} + std::strerror(errno));
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+
+private:
+    int _fd = -1;
+};
+
+// one row of order + 1 values per point: f, f', ..., f^(order)
+static void write_chunk(output_file &out, const std::vector<double> &values,
+                        size_type points, size_type order, bool csv)
+{
+    size_type width = order + 1;
+    if (!csv)
+    {
+        out.write(reinterpret_cast<const char *>(values.data()), sizeof(double) * points * width);
+        return;
+    }
+
+    std::string text;
+    text.reserve(std::size_t{points} * width * 25);
+    char field[32];
+    for (size_type p = 0; p < points; ++p)
+        for (size_type i = 0; i < width; ++i)
+        {
+            int length = std::snprintf(field, sizeof(field), "%.17g", values[p * width + i]);
+            text.append(field, static_cast<std::size_t>(length));
+            text.push_back(i + 1 == width ? '\n' : ',');
+        }
+    out.write(text.data(), text.size());
+}
+
+static void print_usage()
+{
+    std::cerr << "usage: Application <function> <order> <input> <output> [--csv] [--threads n]\n"
+              << "  input: native binary doubles, order <= " << max_order << "\n"
+              << "  functions:";
+    for (const auto &entry : function_registry())
+        std::cerr << ' ' << entry.first;
+    std::cerr << '\n';
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 5)
+    {
+        print_usage();
+        return 1;
+    }
+
+    try
+    {
+        auto kernel_it = function_registry().find(argv[1]);
+        if (kernel_it == function_registry().end())
+            throw std::runtime_error(std::string{"unknown function "} + argv[1]);
+        size_type order = parse_size(argv[2], "order");
+        if (order > max_order)
+            throw std::runtime_error("order > " + std::to_string(max_order));
+        const kernel_type &kernel = kernel_it->second[order];
+
+        bool csv = false;
+        size_type threads = 0;
+        for (int i = 5; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--csv") == 0)
+                csv = true;
+            else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+                threads = parse_size(argv[++i], "thread count");
+            else
+                throw std::runtime_error(std::string{"unknown option "} + argv[i]);
+        }
+
+        mapped_file input{argv[3]};
+        if (input.size() % sizeof(double) != 0)
+            throw std::runtime_error("input size is not a multiple of sizeof(double)");
+        const double *points = static_cast<const double *>(input.data());
+        std::size_t point_count = input.size() / sizeof(double);
+        output_file output{argv[4]};
+
+        // chunk c is evaluated into buffers[c % 2] while chunk c - 1 is written from the other one
+        size_type width = order + 1;
+        std::array<std::vector<double>, 2> buffers{std::vector<double>(std::size_t{chunk_points} * width),
+                                                   std::vector<double>(std::size_t{chunk_points} * width)};
+        std::future<void> pending;
+
+        for (std::size_t first = 0, chunk = 0; first < point_count; first += chunk_points, ++chunk)
+        {
+            size_type count = static_cast<size_type>(std::min<std::size_t>(chunk_points, point_count - first));
+            std::vector<double> &values = buffers[chunk % 2];
+
+            utility::parallel_for(count, threads, [&](size_type begin, size_type end)
+                                  { kernel(points + first, values.data(), begin, end); });
+
+            if (pending.valid())
+                pending.get();
+            pending = std::async(std::launch::async, write_chunk, std::ref(output),
+                                 std::cref(values), count, order, csv);
+        }
+        if (pending.valid())
+            pending.get();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "error: " << e.what() << '\n';
+        return 1;
+    }
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef MATH_ALGEBRA_HPP
+#define MATH_ALGEBRA_HPP
+
+#include "Config.hpp"
+
+#include "Algebra/DualMatrix.hpp"
+#include "Algebra/DualLinearSolve.hpp"
+
+namespace math
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    using algebra::cholesky_solve;
+    using algebra::cholesky_solve_adjoint;
+    using algebra::dot;
+    using algebra::gemm;
+    using algebra::gemv;
+    using algebra::inverse;
+    using algebra::inverse_adjoint;
+    using algebra::solve;
+    using algebra::solve_adjoint;
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math
+
+#endif // MATH_ALGEBRA_HPP
\ No newline at end of file
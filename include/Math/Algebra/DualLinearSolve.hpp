@@ -0,0 +1,199 @@
+#ifndef MATH_ALGEBRA_DUAL_LINEAR_SOLVE_HPP
+#define MATH_ALGEBRA_DUAL_LINEAR_SOLVE_HPP
+
+#include "Config.hpp"
+
+#include "Algebra/DualMatrix.hpp"
+#include "Algebra/Factorization.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+// linear solves over dual matrices differentiated by their analytic rules instead of
+// element by element: the real part of A is factorized once, the tangent
+// dX = A^-1 (dB - dA X) reuses that factorization for every tangent right-hand side
+namespace math
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace algebra::details
+    {
+        // X_r = A_r^-1 B_r, then X_d = A_r^-1 (B_d - A_d X_r), solve(rhs, k) applies A_r^-1 in place
+        template <typename value_type, typename solve_tp>
+        void _dual_solve(const _dual_matrix<value_type> &a,
+                         const value_type *br, const value_type *bd,
+                         value_type *xr, value_type *xd, size_type k, solve_tp solve)
+        {
+            size_type n = a.rows();
+            std::copy(br, br + n * k, xr);
+            solve(xr, k);
+
+            const value_type *ad = a.dual_data();
+            std::copy(bd, bd + n * k, xd);
+            for (size_type i = 0; i < n; ++i)
+                for (size_type p = 0; p < n; ++p)
+                {
+                    const value_type a_ip = ad[i * n + p];
+                    if (a_ip == 0.0)
+                        continue;
+                    for (size_type c = 0; c < k; ++c)
+                        xd[i * k + c] -= a_ip * xr[p * k + c];
+                }
+            solve(xd, k);
+        }
+
+        template <typename value_type>
+        void _check_square(const _dual_matrix<value_type> &a, size_type rhs_rows, const char *message)
+        {
+            if (a.rows() != a.cols() || a.rows() != rhs_rows)
+                throw std::runtime_error(message);
+        }
+    } // namespace math::algebra::details
+
+    namespace algebra
+    {
+        // x = A^-1 b with partial pivoting LU
+        template <typename value_type>
+        details::_dual_vector<value_type> solve(const details::_dual_matrix<value_type> &a,
+                                                const details::_dual_vector<value_type> &b)
+        {
+            details::_check_square(a, b.size(), "dimension mismatch at math::algebra::solve<_dual_matrix>");
+            size_type n = a.rows();
+            std::vector<value_type> lu(a.real_data(), a.real_data() + n * n);
+            std::vector<size_type> pivot(n);
+            details::_lu_factorize(lu.data(), pivot.data(), n);
+
+            details::_dual_vector<value_type> x(n);
+            details::_dual_solve(a, b.real_data(), b.dual_data(), x.real_data(), x.dual_data(), 1,
+                                 [&](value_type *rhs, size_type k)
+                                 { details::_lu_solve(lu.data(), pivot.data(), n, rhs, k); });
+            return x;
+        }
+
+        // X = A^-1 B, all columns of B share the factorization
+        template <typename value_type>
+        details::_dual_matrix<value_type> solve(const details::_dual_matrix<value_type> &a,
+                                                const details::_dual_matrix<value_type> &b)
+        {
+            details::_check_square(a, b.rows(), "dimension mismatch at math::algebra::solve<_dual_matrix>");
+            size_type n = a.rows();
+            std::vector<value_type> lu(a.real_data(), a.real_data() + n * n);
+            std::vector<size_type> pivot(n);
+            details::_lu_factorize(lu.data(), pivot.data(), n);
+
+            details::_dual_matrix<value_type> x(n, b.cols());
+            details::_dual_solve(a, b.real_data(), b.dual_data(), x.real_data(), x.dual_data(), b.cols(),
+                                 [&](value_type *rhs, size_type k)
+                                 { details::_lu_solve(lu.data(), pivot.data(), n, rhs, k); });
+            return x;
+        }
+
+        // x = A^-1 b for symmetric positive definite A, about half the work of solve;
+        // only the lower triangle of the real part is read, dA may be any matrix
+        template <typename value_type>
+        details::_dual_vector<value_type> cholesky_solve(const details::_dual_matrix<value_type> &a,
+                                                         const details::_dual_vector<value_type> &b)
+        {
+            details::_check_square(a, b.size(), "dimension mismatch at math::algebra::cholesky_solve<_dual_matrix>");
+            size_type n = a.rows();
+            std::vector<value_type> l(a.real_data(), a.real_data() + n * n);
+            details::_cholesky_factorize(l.data(), n);
+
+            details::_dual_vector<value_type> x(n);
+            details::_dual_solve(a, b.real_data(), b.dual_data(), x.real_data(), x.dual_data(), 1,
+                                 [&](value_type *rhs, size_type k)
+                                 { details::_cholesky_solve(l.data(), n, rhs, k); });
+            return x;
+        }
+
+        template <typename value_type>
+        details::_dual_matrix<value_type> cholesky_solve(const details::_dual_matrix<value_type> &a,
+                                                         const details::_dual_matrix<value_type> &b)
+        {
+            details::_check_square(a, b.rows(), "dimension mismatch at math::algebra::cholesky_solve<_dual_matrix>");
+            size_type n = a.rows();
+            std::vector<value_type> l(a.real_data(), a.real_data() + n * n);
+            details::_cholesky_factorize(l.data(), n);
+
+            details::_dual_matrix<value_type> x(n, b.cols());
+            details::_dual_solve(a, b.real_data(), b.dual_data(), x.real_data(), x.dual_data(), b.cols(),
+                                 [&](value_type *rhs, size_type k)
+                                 { details::_cholesky_solve(l.data(), n, rhs, k); });
+            return x;
+        }
+
+        // A^-1 as the solve of the identity, so dX = -X dA X comes from the same factorization
+        template <typename value_type>
+        details::_dual_matrix<value_type> inverse(const details::_dual_matrix<value_type> &a)
+        {
+            size_type n = a.rows();
+            details::_dual_matrix<value_type> identity(n, n);
+            for (size_type i = 0; i < n; ++i)
+                identity.set(i, i, calculus::details::_dual_number<value_type>{1.0});
+            return solve(a, identity);
+        }
+
+        // reverse rule of x = A^-1 b for real n x n A and x, given the adjoint x_bar of x:
+        // b_bar += A^-T x_bar and a_bar -= (A^-T x_bar) x^T, a_bar is n x n row-major
+        template <typename value_type>
+        void solve_adjoint(const value_type *a, const value_type *x, const value_type *x_bar,
+                           value_type *a_bar, value_type *b_bar, size_type n)
+        {
+            std::vector<value_type> lu(a, a + n * n);
+            std::vector<size_type> pivot(n);
+            details::_lu_factorize(lu.data(), pivot.data(), n);
+
+            std::vector<value_type> g(x_bar, x_bar + n);
+            details::_lu_solve_transposed(lu.data(), pivot.data(), n, g.data(), 1);
+            for (size_type i = 0; i < n; ++i)
+            {
+                b_bar[i] += g[i];
+                for (size_type j = 0; j < n; ++j)
+                    a_bar[i * n + j] -= g[i] * x[j];
+            }
+        }
+
+        // same rule for symmetric positive definite A, where A^-T = A^-1
+        template <typename value_type>
+        void cholesky_solve_adjoint(const value_type *a, const value_type *x, const value_type *x_bar,
+                                    value_type *a_bar, value_type *b_bar, size_type n)
+        {
+            std::vector<value_type> l(a, a + n * n);
+            details::_cholesky_factorize(l.data(), n);
+
+            std::vector<value_type> g(x_bar, x_bar + n);
+            details::_cholesky_solve(l.data(), n, g.data(), 1);
+            for (size_type i = 0; i < n; ++i)
+            {
+                b_bar[i] += g[i];
+                for (size_type j = 0; j < n; ++j)
+                    a_bar[i * n + j] -= g[i] * x[j];
+            }
+        }
+
+        // reverse rule of X = A^-1 given X itself and its adjoint x_bar: a_bar -= X^T x_bar X^T
+        template <typename value_type>
+        void inverse_adjoint(const value_type *x, const value_type *x_bar, value_type *a_bar, size_type n)
+        {
+            // t = x_bar X^T
+            std::vector<value_type> t(n * n, value_type{});
+            for (size_type i = 0; i < n; ++i)
+                for (size_type p = 0; p < n; ++p)
+                {
+                    const value_type xb_ip = x_bar[i * n + p];
+                    for (size_type j = 0; j < n; ++j)
+                        t[i * n + j] += xb_ip * x[j * n + p];
+                }
+            for (size_type p = 0; p < n; ++p)
+                for (size_type i = 0; i < n; ++i)
+                {
+                    const value_type x_pi = x[p * n + i];
+                    for (size_type j = 0; j < n; ++j)
+                        a_bar[i * n + j] -= x_pi * t[p * n + j];
+                }
+        }
+    } // namespace math::algebra
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math
+
+#endif // MATH_ALGEBRA_DUAL_LINEAR_SOLVE_HPP
@@ -0,0 +1,277 @@
+#ifndef MATH_ALGEBRA_DUAL_MATRIX_HPP
+#define MATH_ALGEBRA_DUAL_MATRIX_HPP
+
+#include "Config.hpp"
+
+#include "Calculus/FOAutoDiff.hpp"
+#include "Utility/Parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace math
+{
+    namespace algebra::details
+    {
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+        // real and dual parts live in two separate contiguous planes,
+        // so every product below reduces to plain floating point kernels
+        template <typename value_type = math::real>
+        class _dual_vector
+        {
+            static_assert(std::is_floating_point<value_type>::value);
+            typedef calculus::details::_dual_number<value_type> element_type;
+
+        public:
+            _dual_vector() = default;
+            explicit _dual_vector(size_type size) : _real(size), _dual(size) {}
+            _dual_vector(const element_type *first, size_type size) : _real(size), _dual(size)
+            {
+                for (size_type i = 0; i < size; ++i)
+                {
+                    _real[i] = first[i].real;
+                    _dual[i] = first[i].dual;
+                }
+            }
+
+            size_type size() const noexcept { return static_cast<size_type>(_real.size()); }
+
+            value_type *real_data() noexcept { return _real.data(); }
+            const value_type *real_data() const noexcept { return _real.data(); }
+            value_type *dual_data() noexcept { return _dual.data(); }
+            const value_type *dual_data() const noexcept { return _dual.data(); }
+
+            element_type operator[](size_type i) const noexcept
+            {
+                return element_type{_real[i], _dual[i]};
+            }
+
+            void set(size_type i, element_type value) noexcept
+            {
+                _real[i] = value.real;
+                _dual[i] = value.dual;
+            }
+
+        private:
+            std::vector<value_type> _real;
+            std::vector<value_type> _dual;
+        };
+
+        // row-major, same split storage as _dual_vector
+        template <typename value_type = math::real>
+        class _dual_matrix
+        {
+            static_assert(std::is_floating_point<value_type>::value);
+            typedef calculus::details::_dual_number<value_type> element_type;
+
+        public:
+            _dual_matrix() = default;
+            _dual_matrix(size_type rows, size_type cols)
+                : _rows{rows}, _cols{cols}, _real(_element_count(rows, cols)), _dual(_real.size()) {}
+
+            size_type rows() const noexcept { return _rows; }
+            size_type cols() const noexcept { return _cols; }
+
+            value_type *real_data() noexcept { return _real.data(); }
+            const value_type *real_data() const noexcept { return _real.data(); }
+            value_type *dual_data() noexcept { return _dual.data(); }
+            const value_type *dual_data() const noexcept { return _dual.data(); }
+
+            element_type operator()(size_type i, size_type j) const noexcept
+            {
+                return element_type{_real[i * _cols + j], _dual[i * _cols + j]};
+            }
+
+            void set(size_type i, size_type j, element_type value) noexcept
+            {
+                _real[i * _cols + j] = value.real;
+                _dual[i * _cols + j] = value.dual;
+            }
+
+        private:
+            // every row-major index i * cols + j is taken in size_type, so rows * cols has to fit in it
+            static std::size_t _element_count(size_type rows, size_type cols)
+            {
+                std::size_t count = std::size_t{rows} * cols;
+                if (cols != 0 && (count / cols != rows || count > std::numeric_limits<size_type>::max()))
+                    throw std::runtime_error("rows * cols overflows size_type at math::algebra::_dual_matrix");
+                return count;
+            }
+
+            size_type _rows = 0;
+            size_type _cols = 0;
+            std::vector<value_type> _real;
+            std::vector<value_type> _dual;
+        };
+
+        // tile sizes of the blocked kernels, a k x n tile of B stays in L2 while rows of A stream through
+        static constexpr size_type _gemm_block_k = 128;
+        static constexpr size_type _gemm_block_n = 256;
+        static constexpr size_type _sum_block = 1024;
+        // below this many multiply-adds threads cost more than they save
+        static constexpr size_type _parallel_threshold = 1u << 16;
+
+        // C[row_begin:row_end, :] += A[row_begin:row_end, :] * B, all row-major
+        template <typename value_type>
+        void _gemm_accumulate(const value_type *a, const value_type *b, value_type *c,
+                              size_type k, size_type n,
+                              size_type row_begin, size_type row_end) noexcept
+        {
+            for (size_type kk = 0; kk < k; kk += _gemm_block_k)
+            {
+                size_type k_end = std::min(kk + _gemm_block_k, k);
+                for (size_type jj = 0; jj < n; jj += _gemm_block_n)
+                {
+                    size_type j_end = std::min(jj + _gemm_block_n, n);
+                    for (size_type i = row_begin; i < row_end; ++i)
+                    {
+                        value_type *c_row = c + i * n;
+                        const value_type *a_row = a + i * k;
+                        for (size_type p = kk; p < k_end; ++p)
+                        {
+                            const value_type a_ip = a_row[p];
+                            const value_type *b_row = b + p * n;
+                            for (size_type j = jj; j < j_end; ++j)
+                                c_row[j] += a_ip * b_row[j];
+                        }
+                    }
+                }
+            }
+        }
+
+        // pairwise sum of a[i] * b[i], rounding error grows with log(n) instead of n
+        template <typename value_type>
+        value_type _pairwise_dot(const value_type *a, const value_type *b, size_type n) noexcept
+        {
+            if (n <= _sum_block)
+            {
+                value_type sum = 0.0;
+                for (size_type i = 0; i < n; ++i)
+                    sum += a[i] * b[i];
+                return sum;
+            }
+            size_type half = n / 2;
+            return _pairwise_dot(a, b, half) + _pairwise_dot(a + half, b + half, n - half);
+        }
+
+        template <typename value_type>
+        value_type _pairwise_sum(value_type *partial, size_type n) noexcept
+        {
+            for (size_type stride = 1; stride < n; stride *= 2)
+                for (size_type i = 0; i + stride < n; i += 2 * stride)
+                    partial[i] += partial[i + stride];
+            return n == 0 ? value_type{} : partial[0];
+        }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+    } // namespace math::algebra::details
+
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace algebra
+    {
+        // x . y, the blocks are summed as a tree in a fixed order,
+        // so the result does not depend on the number of threads
+        template <typename value_type>
+        calculus::details::_dual_number<value_type> dot(const details::_dual_vector<value_type> &x,
+                                                        const details::_dual_vector<value_type> &y,
+                                                        size_type threads = 0)
+        {
+            if (x.size() != y.size())
+                throw std::runtime_error("x.size() != y.size() at math::algebra::dot<_dual_vector>");
+            size_type n = x.size();
+            size_type blocks = (n + details::_sum_block - 1) / details::_sum_block;
+            std::vector<value_type> real_partial(blocks), dual_partial(blocks);
+
+            auto block_sums = [&](size_type first, size_type last)
+            {
+                for (size_type b = first; b < last; ++b)
+                {
+                    size_type offset = b * details::_sum_block;
+                    size_type length = std::min(details::_sum_block, n - offset);
+                    real_partial[b] = details::_pairwise_dot(x.real_data() + offset, y.real_data() + offset, length);
+                    dual_partial[b] = details::_pairwise_dot(x.real_data() + offset, y.dual_data() + offset, length) +
+                                      details::_pairwise_dot(x.dual_data() + offset, y.real_data() + offset, length);
+                }
+            };
+            if (n < details::_parallel_threshold)
+                block_sums(0, blocks);
+            else
+                utility::parallel_for(blocks, threads, block_sums);
+
+            return calculus::details::_dual_number<value_type>{
+                details::_pairwise_sum(real_partial.data(), blocks),
+                details::_pairwise_sum(dual_partial.data(), blocks)};
+        }
+
+        // y = A * x
+        // y_r = A_r * x_r, y_d = A_r * x_d + A_d * x_r
+        template <typename value_type>
+        void gemv(const details::_dual_matrix<value_type> &a,
+                  const details::_dual_vector<value_type> &x,
+                  details::_dual_vector<value_type> &y,
+                  size_type threads = 0)
+        {
+            if (a.cols() != x.size() || a.rows() != y.size())
+                throw std::runtime_error("dimension mismatch at math::algebra::gemv<_dual_matrix>");
+            size_type n = a.cols();
+            const value_type *ar = a.real_data(), *ad = a.dual_data();
+            const value_type *xr = x.real_data(), *xd = x.dual_data();
+            value_type *yr = y.real_data(), *yd = y.dual_data();
+
+            auto rows = [=](size_type first, size_type last)
+            {
+                for (size_type i = first; i < last; ++i)
+                {
+                    const value_type *ar_row = ar + i * n, *ad_row = ad + i * n;
+                    value_type real_sum = 0.0, dual_sum = 0.0;
+                    for (size_type j = 0; j < n; ++j)
+                    {
+                        real_sum += ar_row[j] * xr[j];
+                        dual_sum += ar_row[j] * xd[j] + ad_row[j] * xr[j];
+                    }
+                    yr[i] = real_sum;
+                    yd[i] = dual_sum;
+                }
+            };
+            if (std::size_t{a.rows()} * n < details::_parallel_threshold)
+                rows(0, a.rows());
+            else
+                utility::parallel_for(a.rows(), threads, rows);
+        }
+
+        // C = A * B as three real products over the split planes
+        // C_r = A_r * B_r, C_d = A_r * B_d + A_d * B_r
+        template <typename value_type>
+        void gemm(const details::_dual_matrix<value_type> &a,
+                  const details::_dual_matrix<value_type> &b,
+                  details::_dual_matrix<value_type> &c,
+                  size_type threads = 0)
+        {
+            if (a.cols() != b.rows() || a.rows() != c.rows() || b.cols() != c.cols())
+                throw std::runtime_error("dimension mismatch at math::algebra::gemm<_dual_matrix>");
+            size_type k = a.cols(), n = b.cols();
+            const value_type *ar = a.real_data(), *ad = a.dual_data();
+            const value_type *br = b.real_data(), *bd = b.dual_data();
+            value_type *cr = c.real_data(), *cd = c.dual_data();
+
+            auto rows = [=](size_type first, size_type last)
+            {
+                std::fill(cr + first * n, cr + last * n, value_type{});
+                std::fill(cd + first * n, cd + last * n, value_type{});
+                details::_gemm_accumulate(ar, br, cr, k, n, first, last);
+                details::_gemm_accumulate(ar, bd, cd, k, n, first, last);
+                details::_gemm_accumulate(ad, br, cd, k, n, first, last);
+            };
+            if (std::size_t{a.rows()} * k * n < details::_parallel_threshold)
+                rows(0, a.rows());
+            else
+                utility::parallel_for(a.rows(), threads, rows);
+        }
+    } // namespace math::algebra
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math
+
+#endif // MATH_ALGEBRA_DUAL_MATRIX_HPP
\ No newline at end of file
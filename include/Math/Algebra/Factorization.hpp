@@ -0,0 +1,168 @@
+#ifndef MATH_ALGEBRA_FACTORIZATION_HPP
+#define MATH_ALGEBRA_FACTORIZATION_HPP
+
+#include "Config.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+// dense kernels on row-major n x n matrices, meant for the small systems met inside derivative rules
+namespace math::algebra::details
+{
+    // P * A = L * U in place with partial pivoting, L has a unit diagonal and is stored below U,
+    // pivot[i] is the row swapped into row i
+    template <typename value_type>
+    void _lu_factorize(value_type *a, size_type *pivot, size_type n)
+    {
+        for (size_type k = 0; k < n; ++k)
+        {
+            size_type p = k;
+            value_type largest = std::abs(a[k * n + k]);
+            for (size_type i = k + 1; i < n; ++i)
+                if (std::abs(a[i * n + k]) > largest)
+                {
+                    largest = std::abs(a[i * n + k]);
+                    p = i;
+                }
+            if (largest == 0.0)
+                throw std::runtime_error("singular matrix at math::algebra::details::_lu_factorize");
+
+            pivot[k] = p;
+            if (p != k)
+                for (size_type j = 0; j < n; ++j)
+                    std::swap(a[k * n + j], a[p * n + j]);
+
+            value_type inv = 1.0 / a[k * n + k];
+            for (size_type i = k + 1; i < n; ++i)
+            {
+                value_type l_ik = a[i * n + k] *= inv;
+                for (size_type j = k + 1; j < n; ++j)
+                    a[i * n + j] -= l_ik * a[k * n + j];
+            }
+        }
+    }
+
+    // solves A * X = B in place for the factors of _lu_factorize,
+    // B is n x rhs_count row-major so every row operation runs over all right-hand sides at once
+    template <typename value_type>
+    void _lu_solve(const value_type *lu, const size_type *pivot, size_type n,
+                   value_type *b, size_type rhs_count) noexcept
+    {
+        for (size_type k = 0; k < n; ++k)
+            if (pivot[k] != k)
+                for (size_type c = 0; c < rhs_count; ++c)
+                    std::swap(b[k * rhs_count + c], b[pivot[k] * rhs_count + c]);
+
+        for (size_type i = 1; i < n; ++i)
+            for (size_type k = 0; k < i; ++k)
+            {
+                value_type l_ik = lu[i * n + k];
+                for (size_type c = 0; c < rhs_count; ++c)
+                    b[i * rhs_count + c] -= l_ik * b[k * rhs_count + c];
+            }
+
+        for (size_type i = n; i-- > 0;)
+        {
+            for (size_type k = i + 1; k < n; ++k)
+            {
+                value_type u_ik = lu[i * n + k];
+                for (size_type c = 0; c < rhs_count; ++c)
+                    b[i * rhs_count + c] -= u_ik * b[k * rhs_count + c];
+            }
+            value_type inv = 1.0 / lu[i * n + i];
+            for (size_type c = 0; c < rhs_count; ++c)
+                b[i * rhs_count + c] *= inv;
+        }
+    }
+
+    // solves A^T * X = B in place for the factors of _lu_factorize, A^T = U^T * L^T * P
+    template <typename value_type>
+    void _lu_solve_transposed(const value_type *lu, const size_type *pivot, size_type n,
+                              value_type *b, size_type rhs_count) noexcept
+    {
+        for (size_type i = 0; i < n; ++i)
+        {
+            for (size_type k = 0; k < i; ++k)
+            {
+                value_type u_ki = lu[k * n + i];
+                for (size_type c = 0; c < rhs_count; ++c)
+                    b[i * rhs_count + c] -= u_ki * b[k * rhs_count + c];
+            }
+            value_type inv = 1.0 / lu[i * n + i];
+            for (size_type c = 0; c < rhs_count; ++c)
+                b[i * rhs_count + c] *= inv;
+        }
+
+        for (size_type i = n; i-- > 0;)
+            for (size_type k = i + 1; k < n; ++k)
+            {
+                value_type l_ki = lu[k * n + i];
+                for (size_type c = 0; c < rhs_count; ++c)
+                    b[i * rhs_count + c] -= l_ki * b[k * rhs_count + c];
+            }
+
+        for (size_type k = n; k-- > 0;)
+            if (pivot[k] != k)
+                for (size_type c = 0; c < rhs_count; ++c)
+                    std::swap(b[k * rhs_count + c], b[pivot[k] * rhs_count + c]);
+    }
+
+    // A = L * L^T in place for symmetric positive definite A, only the lower triangle is read and written
+    template <typename value_type>
+    void _cholesky_factorize(value_type *a, size_type n)
+    {
+        for (size_type j = 0; j < n; ++j)
+        {
+            value_type d = a[j * n + j];
+            for (size_type k = 0; k < j; ++k)
+                d -= a[j * n + k] * a[j * n + k];
+            if (!(d > 0.0))
+                throw std::runtime_error("matrix is not positive definite at math::algebra::details::_cholesky_factorize");
+            value_type l_jj = std::sqrt(d);
+            a[j * n + j] = l_jj;
+
+            value_type inv = 1.0 / l_jj;
+            for (size_type i = j + 1; i < n; ++i)
+            {
+                value_type sum = a[i * n + j];
+                for (size_type k = 0; k < j; ++k)
+                    sum -= a[i * n + k] * a[j * n + k];
+                a[i * n + j] = sum * inv;
+            }
+        }
+    }
+
+    // solves A * X = B in place for the factor of _cholesky_factorize, B is n x rhs_count row-major
+    template <typename value_type>
+    void _cholesky_solve(const value_type *l, size_type n, value_type *b, size_type rhs_count) noexcept
+    {
+        for (size_type i = 0; i < n; ++i)
+        {
+            for (size_type k = 0; k < i; ++k)
+            {
+                value_type l_ik = l[i * n + k];
+                for (size_type c = 0; c < rhs_count; ++c)
+                    b[i * rhs_count + c] -= l_ik * b[k * rhs_count + c];
+            }
+            value_type inv = 1.0 / l[i * n + i];
+            for (size_type c = 0; c < rhs_count; ++c)
+                b[i * rhs_count + c] *= inv;
+        }
+
+        for (size_type i = n; i-- > 0;)
+        {
+            for (size_type k = i + 1; k < n; ++k)
+            {
+                value_type l_ki = l[k * n + i];
+                for (size_type c = 0; c < rhs_count; ++c)
+                    b[i * rhs_count + c] -= l_ki * b[k * rhs_count + c];
+            }
+            value_type inv = 1.0 / l[i * n + i];
+            for (size_type c = 0; c < rhs_count; ++c)
+                b[i * rhs_count + c] *= inv;
+        }
+    }
+} // namespace math::algebra::details
+
+#endif // MATH_ALGEBRA_FACTORIZATION_HPP
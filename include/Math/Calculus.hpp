@@ -3,12 +3,45 @@
 
 #include "Config.hpp"
 
+#include "Calculus/CodeGen.hpp"
+#include "Calculus/CustomRule.hpp"
 #include "Calculus/FODerivative.hpp"
 #include "Calculus/HODerivative.hpp"
+#include "Calculus/HOSeries.hpp"
+#include "Calculus/FOJacobianProduct.hpp"
+#include "Calculus/FODerivativeCache.hpp"
+#include "Calculus/FOIncremental.hpp"
+#include "Calculus/FODerivativeService.hpp"
+#include "Calculus/FOImplicit.hpp"
+#include "Calculus/FOMinimize.hpp"
+#include "Calculus/FOSensitivity.hpp"
+#include "Calculus/FOSparseDual.hpp"
+#include "Calculus/Interpolation.hpp"
+#include "Calculus/FOPathwise.hpp"
+#include "Calculus/ExternTemplates.hpp"
 
 namespace math
 {
     using calculus::first_order_derivative;
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    using calculus::custom_rule;
+    using calculus::derivative_service;
+    using calculus::dopri5_sensitivities;
+    using calculus::generate_derivative_code;
+    using calculus::high_order_derivatives;
+    using calculus::implicit_derivative;
+    using calculus::incremental;
+    using calculus::interpolant;
+    using calculus::interpolation_kind;
+    using calculus::jvp;
+    using calculus::lbfgs;
+    using calculus::memoize;
+    using calculus::pathwise_sensitivities;
+    using calculus::rk4_sensitivities;
+    using calculus::sparse_gradient;
+    using calculus::taylor_series;
+    using calculus::vjp;
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
 } // namespace math
 
 #endif // MATH_CALCULUS_HPP
\ No newline at end of file
@@ -0,0 +1,482 @@
+#ifndef MATH_CALCULUS_CODE_GEN_HPP
+#define MATH_CALCULUS_CODE_GEN_HPP
+
+#include "Config.hpp"
+
+#include "FOAutoDiff.hpp"
+#include "FOIncremental.hpp"
+#include "Tape.hpp"
+
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// f is traced once on _recorded_number, the tape is turned into an expression graph that is
+// differentiated symbolically and printed as straight-line C++ without any dual type in it
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace details
+    {
+        inline bool _is_binary(_tape_op op) noexcept
+        {
+            return op == _tape_op::add || op == _tape_op::sub || op == _tape_op::mul ||
+                   op == _tape_op::div || op == _tape_op::pow;
+        }
+
+        // every node is unique, so a repeated subexpression is one node (common subexpression elimination),
+        // operations on constants are folded and the identities of 0 and 1 are applied when a node is made
+        template <typename value_type>
+        class _expression_graph
+        {
+        public:
+            static constexpr size_type none = std::numeric_limits<size_type>::max();
+
+            // value is the constant, or the position for an input
+            struct node_type
+            {
+                _tape_op op;
+                size_type lhs;
+                size_type rhs;
+                value_type value;
+            };
+
+            size_type input(size_type position)
+            {
+                return _insert(node_type{_tape_op::input, 0, 0, static_cast<value_type>(position)});
+            }
+
+            size_type constant(value_type value)
+            {
+                return _insert(node_type{_tape_op::constant, 0, 0, value});
+            }
+
+            size_type make(_tape_op op, size_type x)
+            {
+                return make(op, x, x);
+            }
+
+            // unary operations ignore rhs
+            size_type make(_tape_op op, size_type lhs, size_type rhs)
+            {
+                if (!_is_binary(op))
+                    rhs = lhs;
+                if (_is_constant(lhs) && _is_constant(rhs))
+                    return constant(_evaluate_tape_op(op, _dual_number<value_type>{_nodes[lhs].value},
+                                                      _dual_number<value_type>{_nodes[rhs].value})
+                                        .real);
+
+                switch (op)
+                {
+                case _tape_op::add:
+                    if (_is_constant(lhs, 0.0))
+                        return rhs;
+                    if (_is_constant(rhs, 0.0))
+                        return lhs;
+                    if (lhs > rhs)
+                        std::swap(lhs, rhs);
+                    break;
+                case _tape_op::sub:
+                    if (_is_constant(rhs, 0.0))
+                        return lhs;
+                    if (_is_constant(lhs, 0.0))
+                        return make(_tape_op::neg, rhs);
+                    if (lhs == rhs)
+                        return constant(0.0);
+                    break;
+                case _tape_op::mul:
+                    if (_is_constant(lhs, 0.0) || _is_constant(rhs, 0.0))
+                        return constant(0.0);
+                    if (_is_constant(lhs, 1.0))
+                        return rhs;
+                    if (_is_constant(rhs, 1.0))
+                        return lhs;
+                    if (_is_constant(lhs, -1.0))
+                        return make(_tape_op::neg, rhs);
+                    if (_is_constant(rhs, -1.0))
+                        return make(_tape_op::neg, lhs);
+                    if (lhs == rhs)
+                        return make(_tape_op::sq, lhs);
+                    if (lhs > rhs)
+                        std::swap(lhs, rhs);
+                    break;
+                case _tape_op::div:
+                    if (_is_constant(rhs, 1.0))
+                        return lhs;
+                    if (_is_constant(rhs, -1.0))
+                        return make(_tape_op::neg, lhs);
+                    if (_is_constant(lhs, 0.0))
+                        return constant(0.0);
+                    if (lhs == rhs)
+                        return constant(1.0);
+                    break;
+                case _tape_op::pow:
+                    if (_is_constant(rhs, 0.0))
+                        return constant(1.0);
+                    if (_is_constant(rhs, 1.0))
+                        return lhs;
+                    if (_is_constant(rhs, 2.0))
+                        return make(_tape_op::sq, lhs);
+                    if (_is_constant(rhs, 0.5))
+                        return make(_tape_op::sqrt, lhs);
+                    break;
+                case _tape_op::neg:
+                    if (_nodes[lhs].op == _tape_op::neg)
+                        return _nodes[lhs].lhs;
+                    break;
+                case _tape_op::sq:
+                case _tape_op::abs:
+                    if (_nodes[lhs].op == _tape_op::neg)
+                        return make(op, _nodes[lhs].lhs);
+                    break;
+                default:
+                    break;
+                }
+                return _insert(node_type{op, lhs, rhs, value_type{}});
+            }
+
+            // d output / d node for every node up to output, none where output does not depend on it
+            std::vector<size_type> adjoints(size_type output)
+            {
+                std::vector<size_type> adjoint(output + 1, none);
+                adjoint[output] = constant(1.0);
+                for (size_type k = output + 1; k-- > 0;)
+                {
+                    if (adjoint[k] == none)
+                        continue;
+                    node_type node = _nodes[k];
+                    if (node.op == _tape_op::input || node.op == _tape_op::constant)
+                        continue;
+                    _accumulate(adjoint, node.lhs, make(_tape_op::mul, adjoint[k], _partial(k, false)));
+                    if (_is_binary(node.op) && !_is_constant(node.rhs))
+                        _accumulate(adjoint, node.rhs, make(_tape_op::mul, adjoint[k], _partial(k, true)));
+                }
+                return adjoint;
+            }
+
+            size_type size() const noexcept { return static_cast<size_type>(_nodes.size()); }
+            const node_type &operator[](size_type i) const noexcept { return _nodes[i]; }
+
+        private:
+            bool _is_constant(size_type i) const noexcept
+            {
+                return _nodes[i].op == _tape_op::constant;
+            }
+
+            bool _is_constant(size_type i, value_type value) const noexcept
+            {
+                return _nodes[i].op == _tape_op::constant && _nodes[i].value == value;
+            }
+
+            size_type _insert(const node_type &node)
+            {
+                auto key = std::make_tuple(node.op, node.lhs, node.rhs, node.value);
+                auto found = _index.find(key);
+                if (found != _index.end())
+                    return found->second;
+                _nodes.push_back(node);
+                size_type i = static_cast<size_type>(_nodes.size() - 1);
+                _index.emplace(key, i);
+                return i;
+            }
+
+            void _accumulate(std::vector<size_type> &adjoint, size_type i, size_type contribution)
+            {
+                adjoint[i] = adjoint[i] == none ? contribution : make(_tape_op::add, adjoint[i], contribution);
+            }
+
+            // d node k / d lhs, or d node k / d rhs
+            size_type _partial(size_type k, bool wrt_rhs)
+            {
+                node_type node = _nodes[k];
+                size_type a = node.lhs, b = node.rhs;
+                size_type one = constant(1.0);
+                switch (node.op)
+                {
+                case _tape_op::add:
+                    return one;
+                case _tape_op::sub:
+                    return constant(wrt_rhs ? -1.0 : 1.0);
+                case _tape_op::mul:
+                    return wrt_rhs ? a : b;
+                case _tape_op::div:
+                    return wrt_rhs ? make(_tape_op::neg, make(_tape_op::div, k, b)) : make(_tape_op::div, one, b);
+                case _tape_op::pow:
+                    return make(_tape_op::mul, b, make(_tape_op::pow, a, constant(_nodes[b].value - 1.0)));
+                case _tape_op::neg:
+                    return constant(-1.0);
+                case _tape_op::abs:
+                    return make(_tape_op::div, a, k);
+                case _tape_op::sq:
+                    return make(_tape_op::mul, constant(2.0), a);
+                case _tape_op::sqrt:
+                    return make(_tape_op::div, constant(0.5), k);
+                case _tape_op::cbrt:
+                    return make(_tape_op::div, constant(1.0 / 3.0), make(_tape_op::sq, k));
+                case _tape_op::exp:
+                    return k;
+                case _tape_op::log:
+                    return make(_tape_op::div, one, a);
+                case _tape_op::sin:
+                    return make(_tape_op::cos, a);
+                case _tape_op::cos:
+                    return make(_tape_op::neg, make(_tape_op::sin, a));
+                case _tape_op::tan:
+                    return make(_tape_op::add, one, make(_tape_op::sq, k));
+                case _tape_op::asin:
+                    return make(_tape_op::div, one, make(_tape_op::sqrt, make(_tape_op::sub, one, make(_tape_op::sq, a))));
+                case _tape_op::acos:
+                    return make(_tape_op::neg, make(_tape_op::div, one, make(_tape_op::sqrt, make(_tape_op::sub, one, make(_tape_op::sq, a)))));
+                case _tape_op::atan:
+                    return make(_tape_op::div, one, make(_tape_op::add, one, make(_tape_op::sq, a)));
+                case _tape_op::sinh:
+                    return make(_tape_op::cosh, a);
+                case _tape_op::cosh:
+                    return make(_tape_op::sinh, a);
+                case _tape_op::tanh:
+                    return make(_tape_op::sub, one, make(_tape_op::sq, k));
+                default:
+                    throw std::runtime_error("no derivative rule at math::calculus::details::_expression_graph");
+                }
+            }
+
+            std::vector<node_type> _nodes;
+            std::map<std::tuple<_tape_op, size_type, size_type, value_type>, size_type> _index;
+        };
+
+        template <typename value_type>
+        constexpr size_type _expression_graph<value_type>::none;
+
+        inline const char *_function_name(_tape_op op) noexcept
+        {
+            switch (op)
+            {
+            case _tape_op::abs: return "std::abs";
+            case _tape_op::sqrt: return "std::sqrt";
+            case _tape_op::cbrt: return "std::cbrt";
+            case _tape_op::exp: return "std::exp";
+            case _tape_op::log: return "std::log";
+            case _tape_op::sin: return "std::sin";
+            case _tape_op::cos: return "std::cos";
+            case _tape_op::tan: return "std::tan";
+            case _tape_op::asin: return "std::asin";
+            case _tape_op::acos: return "std::acos";
+            case _tape_op::atan: return "std::atan";
+            case _tape_op::sinh: return "std::sinh";
+            case _tape_op::cosh: return "std::cosh";
+            case _tape_op::tanh: return "std::tanh";
+            default: return "";
+            }
+        }
+
+        // straight-line statements of the nodes the outputs need, in node order
+        template <typename value_type>
+        class _code_writer
+        {
+        public:
+            _code_writer(const _expression_graph<value_type> &graph, const std::vector<size_type> &outputs)
+                : _graph(graph), _needed(graph.size(), false)
+            {
+                for (size_type output : outputs)
+                    _needed[output] = true;
+                for (size_type k = graph.size(); k-- > 0;)
+                    if (_needed[k] && graph[k].op != _tape_op::input && graph[k].op != _tape_op::constant)
+                        _needed[graph[k].lhs] = _needed[graph[k].rhs] = true;
+            }
+
+            // input i is read from x[i * stride + offset], stride and offset are C++ expressions or empty
+            void body(std::ostream &out, const std::string &indent, const std::string &stride, const std::string &offset) const
+            {
+                for (size_type k = 0; k < _graph.size(); ++k)
+                {
+                    if (!_needed[k] || _graph[k].op == _tape_op::constant)
+                        continue;
+                    const auto &node = _graph[k];
+                    out << indent << "const value_type " << name(k) << " = ";
+                    if (node.op == _tape_op::input)
+                        out << "x[" << element(static_cast<size_type>(node.value), stride, offset) << "]";
+                    else
+                        _expression(out, node);
+                    out << ";\n";
+                }
+            }
+
+            std::string name(size_type k) const
+            {
+                const auto &node = _graph[k];
+                std::ostringstream out;
+                out.precision(std::numeric_limits<value_type>::max_digits10);
+                if (node.op == _tape_op::constant)
+                    out << "value_type(" << node.value << ")";
+                else if (node.op == _tape_op::input)
+                    out << "x" << static_cast<size_type>(node.value);
+                else
+                    out << "t" << k;
+                return out.str();
+            }
+
+            // i * stride + offset without the terms that are 0
+            static std::string element(size_type i, const std::string &stride, const std::string &offset)
+            {
+                std::ostringstream out;
+                if (stride.empty() || i == 0)
+                    out << (stride.empty() ? std::to_string(i) : "");
+                else
+                    out << (i == 1 ? "" : std::to_string(i) + " * ") << stride;
+                if (!offset.empty())
+                    out << (stride.empty() || i == 0 ? "" : " + ") << offset;
+                return out.str();
+            }
+
+        private:
+            void _expression(std::ostream &out, const typename _expression_graph<value_type>::node_type &node) const
+            {
+                std::string a = name(node.lhs), b = name(node.rhs);
+                switch (node.op)
+                {
+                case _tape_op::add: out << a << " + " << b; break;
+                case _tape_op::sub: out << a << " - " << b; break;
+                case _tape_op::mul: out << a << " * " << b; break;
+                case _tape_op::div: out << a << " / " << b; break;
+                case _tape_op::pow: out << "std::pow(" << a << ", " << b << ")"; break;
+                case _tape_op::neg: out << "-" << a; break;
+                case _tape_op::sq: out << a << " * " << a; break;
+                default: out << _function_name(node.op) << "(" << a << ")"; break;
+                }
+            }
+
+            const _expression_graph<value_type> &_graph;
+            std::vector<bool> _needed;
+        };
+
+        inline bool _is_identifier(const std::string &name) noexcept
+        {
+            if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0])))
+                return false;
+            for (char c : name)
+                if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_')
+                    return false;
+            return true;
+        }
+
+        template <typename func_tp, typename value_type, std::size_t... index>
+        size_type _trace_to_graph(func_tp &f, const std::array<value_type, sizeof...(index)> &x,
+                                  _expression_graph<value_type> &graph, std::index_sequence<index...>)
+        {
+            _tape<value_type> tape;
+            std::array<_recorded_number<value_type>, sizeof...(index)> inputs{tape.input(x[index])...};
+            auto result = f(inputs[index]...);
+            size_type output = _output_index(tape, result);
+
+            std::vector<size_type> node_of(tape.size());
+            size_type position = 0;
+            for (size_type k = 0; k < tape.size(); ++k)
+            {
+                const auto &node = tape[k];
+                if (_is_guard(node.op))
+                    throw std::runtime_error("f branches on its inputs at math::calculus::generate_derivative_code");
+                if (node.op == _tape_op::input)
+                    node_of[k] = graph.input(position++);
+                else if (node.op == _tape_op::constant)
+                    node_of[k] = graph.constant(node.value);
+                else
+                    node_of[k] = graph.make(node.op, node_of[node.lhs], node_of[node.rhs]);
+            }
+            return node_of[output];
+        }
+    } // namespace math::calculus::details
+
+    // header-only C++ source defining, for value_type = float or double,
+    //     value_type name(const value_type *x, value_type *gradient[, value_type *hessian])
+    // which returns f(x) and writes gradient[i] and hessian[i * var_count + j], and
+    //     void name_batch(const value_type *x, std::size_t count, value_type *value, value_type *gradient[, value_type *hessian])
+    // which does the same for count points stored input-major, x[i * count + p] is input i of point p,
+    // so its loop over p vectorizes; f is traced at x and must not branch on its inputs
+    template <size_type var_count, typename value_type = math::real, typename func_tp>
+    std::string generate_derivative_code(func_tp f, const std::array<value_type, var_count> &x,
+                                         const std::string &name, bool hessian = false)
+    {
+        if (!details::_is_identifier(name))
+            throw std::runtime_error("name is not an identifier at math::calculus::generate_derivative_code");
+
+        details::_expression_graph<value_type> graph;
+        size_type value = details::_trace_to_graph(f, x, graph, std::make_index_sequence<var_count>{});
+        std::vector<size_type> inputs(var_count);
+        for (size_type i = 0; i < var_count; ++i)
+            inputs[i] = graph.input(i);
+
+        auto derivative = [&](const std::vector<size_type> &adjoint, size_type i)
+        {
+            return inputs[i] < adjoint.size() && adjoint[inputs[i]] != graph.none ? adjoint[inputs[i]] : graph.constant(0.0);
+        };
+        std::vector<size_type> gradient(var_count), hessian_upper;
+        auto adjoint = graph.adjoints(value);
+        for (size_type i = 0; i < var_count; ++i)
+            gradient[i] = derivative(adjoint, i);
+        if (hessian)
+            for (size_type i = 0; i < var_count; ++i)
+            {
+                auto second = graph.adjoints(gradient[i]);
+                for (size_type j = i; j < var_count; ++j)
+                    hessian_upper.push_back(derivative(second, j));
+            }
+
+        std::vector<size_type> outputs = gradient;
+        outputs.push_back(value);
+        outputs.insert(outputs.end(), hessian_upper.begin(), hessian_upper.end());
+        details::_code_writer<value_type> writer{graph, outputs};
+
+        auto assignments = [&](std::ostream &out, const std::string &indent, const std::string &stride, const std::string &offset)
+        {
+            for (size_type i = 0; i < var_count; ++i)
+                out << indent << "gradient[" << writer.element(i, stride, offset) << "] = " << writer.name(gradient[i]) << ";\n";
+            size_type k = 0;
+            for (size_type i = 0; i < var_count && hessian; ++i)
+                for (size_type j = i; j < var_count; ++j, ++k)
+                {
+                    out << indent << "hessian[" << writer.element(i * var_count + j, stride, offset) << "] = " << writer.name(hessian_upper[k]) << ";\n";
+                    if (j != i)
+                        out << indent << "hessian[" << writer.element(j * var_count + i, stride, offset) << "] = " << writer.name(hessian_upper[k]) << ";\n";
+                }
+        };
+
+        std::string guard = name;
+        for (char &c : guard)
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        guard += "_HPP";
+
+        std::ostringstream out;
+        out << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+            << "// generated by math::calculus::generate_derivative_code, " << var_count << " inputs\n\n"
+            << "#include <cmath>\n#include <cstddef>\n\n";
+
+        out << "template <typename value_type>\n"
+            << "inline value_type " << name << "(const value_type *x, value_type *gradient"
+            << (hessian ? ", value_type *hessian" : "") << ")\n{\n";
+        writer.body(out, "    ", "", "");
+        assignments(out, "    ", "", "");
+        out << "    return " << writer.name(value) << ";\n}\n\n";
+
+        out << "template <typename value_type>\n"
+            << "inline void " << name << "_batch(const value_type *__restrict x, std::size_t count, value_type *__restrict value, "
+            << "value_type *__restrict gradient" << (hessian ? ", value_type *__restrict hessian" : "") << ")\n{\n"
+            << "    for (std::size_t p = 0; p < count; ++p)\n    {\n";
+        writer.body(out, "        ", "count", "p");
+        out << "        value[p] = " << writer.name(value) << ";\n";
+        assignments(out, "        ", "count", "p");
+        out << "    }\n}\n\n#endif // " << guard << "\n";
+        return out.str();
+    }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_CODE_GEN_HPP
@@ -0,0 +1,214 @@
+#ifndef MATH_CALCULUS_CUSTOM_RULE_HPP
+#define MATH_CALCULUS_CUSTOM_RULE_HPP
+
+#include "Config.hpp"
+
+#include "FOAutoDiff.hpp"
+#include "FOSparseDual.hpp"
+#include "HOAutoDiff.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// a custom rule turns a black-box function with a known derivative into an atomic operation:
+// the primal runs once on plain values and its derivative is applied by the chain rule,
+// nothing inside the function body is traced
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace details
+    {
+        // f, f' and optionally taylor(x, d, count), which writes f(x), f'(x), ..., f^(count - 1)(x) to d,
+        // without it Taylor numbers beyond first order are rejected
+        template <typename primal_tp, typename derivative_tp, typename taylor_tp = std::nullptr_t>
+        class _custom_rule
+        {
+        public:
+            _custom_rule(primal_tp f, derivative_tp df, taylor_tp taylor = taylor_tp{})
+                : _primal(std::move(f)), _derivative(std::move(df)), _taylor(std::move(taylor)) {}
+
+            template <typename value_type, typename = std::enable_if_t<std::is_floating_point<value_type>::value>>
+            value_type operator()(value_type x) const
+            {
+                return _primal(x);
+            }
+
+            template <typename value_type>
+            _dual_number<value_type> operator()(const _dual_number<value_type> &x) const
+            {
+                return _dual_number<value_type>{_primal(x.real), _derivative(x.real) * x.dual};
+            }
+
+            template <typename value_type, size_type inline_capacity>
+            _sparse_dual_number<value_type, inline_capacity> operator()(
+                const _sparse_dual_number<value_type, inline_capacity> &x) const
+            {
+                auto result = x * static_cast<value_type>(_derivative(x.real));
+                result.real = _primal(x.real);
+                return result;
+            }
+
+            // f(x) = sum f^(k)(x0) / k! * (x - x0)^k, evaluated by Horner's rule in h = x - x0
+            template <typename value_type, size_type highest_order>
+            _high_order_dual_number<value_type, highest_order> operator()(
+                const _high_order_dual_number<value_type, highest_order> &x) const
+            {
+                value_type x0 = x.derivative(0);
+                std::array<value_type, highest_order> c;
+                _fill_taylor(_taylor, x0, c.data(), highest_order);
+                value_type factorial = 1.0;
+                for (size_type k = 2; k < highest_order; ++k)
+                    c[k] /= (factorial *= k);
+
+                auto h = x - x0;
+                auto result = h * value_type{};
+                for (size_type k = highest_order; k-- > 0;)
+                {
+                    result *= h;
+                    result += c[k];
+                }
+                return result;
+            }
+
+            // result[i] = f(x[i]) for i < count
+            template <typename value_type>
+            void operator()(const _dual_number<value_type> *x, _dual_number<value_type> *result, size_type count) const
+            {
+                for (size_type i = 0; i < count; ++i)
+                    result[i] = (*this)(x[i]);
+            }
+
+        private:
+            template <typename value_type>
+            void _fill_taylor(std::nullptr_t, value_type x, value_type *d, size_type count) const
+            {
+                if (count > 2)
+                    throw std::runtime_error("no Taylor coefficients beyond f' at math::calculus::custom_rule");
+                d[0] = _primal(x);
+                if (count > 1)
+                    d[1] = _derivative(x);
+            }
+
+            template <typename fill_tp, typename value_type>
+            void _fill_taylor(const fill_tp &taylor, value_type x, value_type *d, size_type count) const
+            {
+                taylor(x, d, count);
+            }
+
+            primal_tp _primal;
+            derivative_tp _derivative;
+            taylor_tp _taylor;
+        };
+
+        // f maps std::array<value_type, n> to value_type, gradient maps it to std::array<value_type, n>;
+        // only first order information is known, so Taylor numbers are limited to order 1
+        template <size_type n, typename primal_tp, typename gradient_tp>
+        class _custom_gradient_rule
+        {
+        public:
+            _custom_gradient_rule(primal_tp f, gradient_tp gradient)
+                : _primal(std::move(f)), _gradient(std::move(gradient)) {}
+
+            template <typename value_type, typename = std::enable_if_t<std::is_floating_point<value_type>::value>>
+            value_type operator()(const std::array<value_type, n> &x) const
+            {
+                return _primal(x);
+            }
+
+            template <typename value_type>
+            _dual_number<value_type> operator()(const std::array<_dual_number<value_type>, n> &x) const
+            {
+                std::array<value_type, n> x0;
+                for (size_type i = 0; i < n; ++i)
+                    x0[i] = x[i].real;
+                auto g = _gradient(x0);
+                value_type dual = 0.0;
+                for (size_type i = 0; i < n; ++i)
+                    dual += g[i] * x[i].dual;
+                return _dual_number<value_type>{_primal(x0), dual};
+            }
+
+            template <typename value_type, size_type inline_capacity>
+            _sparse_dual_number<value_type, inline_capacity> operator()(
+                const std::array<_sparse_dual_number<value_type, inline_capacity>, n> &x) const
+            {
+                std::array<value_type, n> x0;
+                for (size_type i = 0; i < n; ++i)
+                    x0[i] = x[i].real;
+                auto g = _gradient(x0);
+                _sparse_dual_number<value_type, inline_capacity> result{value_type{}};
+                for (size_type i = 0; i < n; ++i)
+                    result += x[i] * static_cast<value_type>(g[i]);
+                result.real = _primal(x0);
+                return result;
+            }
+
+            template <typename value_type, size_type highest_order>
+            _high_order_dual_number<value_type, highest_order> operator()(
+                const std::array<_high_order_dual_number<value_type, highest_order>, n> &x) const
+            {
+                static_assert(highest_order <= 2, "a gradient rule carries no second order information");
+                std::array<value_type, n> x0;
+                for (size_type i = 0; i < n; ++i)
+                    x0[i] = x[i].derivative(0);
+                auto g = _gradient(x0);
+                auto result = (x[0] - x0[0]) * g[0];
+                for (size_type i = 1; i < n; ++i)
+                    axpy(static_cast<value_type>(g[i]), x[i] - x0[i], result);
+                result += _primal(x0);
+                return result;
+            }
+
+            // f(x_1, ..., x_n) with the arguments spelled out
+            template <typename... var_tp, typename = std::enable_if_t<sizeof...(var_tp) == n>>
+            auto operator()(const var_tp &...vars) const
+            {
+                return (*this)(std::array<std::common_type_t<var_tp...>, n>{vars...});
+            }
+
+            // count evaluations, x holds count groups of n inputs back to back
+            template <typename value_type>
+            void operator()(const _dual_number<value_type> *x, _dual_number<value_type> *result, size_type count) const
+            {
+                std::array<_dual_number<value_type>, n> group;
+                for (size_type k = 0; k < count; ++k)
+                {
+                    std::copy(x + k * n, x + (k + 1) * n, group.begin());
+                    result[k] = (*this)(group);
+                }
+            }
+
+        private:
+            primal_tp _primal;
+            gradient_tp _gradient;
+        };
+    } // namespace math::calculus::details
+
+    // f(x) with derivative df(x), both on plain values
+    template <typename primal_tp, typename derivative_tp>
+    auto custom_rule(primal_tp f, derivative_tp df)
+    {
+        return details::_custom_rule<primal_tp, derivative_tp>{std::move(f), std::move(df)};
+    }
+
+    // taylor(x, d, count) supplies f(x), f'(x), ..., f^(count - 1)(x) for Taylor numbers of any order
+    template <typename primal_tp, typename derivative_tp, typename taylor_tp>
+    auto custom_rule(primal_tp f, derivative_tp df, taylor_tp taylor)
+    {
+        return details::_custom_rule<primal_tp, derivative_tp, taylor_tp>{std::move(f), std::move(df), std::move(taylor)};
+    }
+
+    // f of n inputs with its gradient
+    template <size_type n, typename primal_tp, typename gradient_tp>
+    auto custom_rule(primal_tp f, gradient_tp gradient)
+    {
+        return details::_custom_gradient_rule<n, primal_tp, gradient_tp>{std::move(f), std::move(gradient)};
+    }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_CUSTOM_RULE_HPP
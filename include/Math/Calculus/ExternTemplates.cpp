@@ -0,0 +1,13 @@
+#include "Config.hpp"
+
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+#include "ExternTemplates.hpp"
+
+namespace math
+{
+    MATH_FO_AUTO_DIFF_TEMPLATES(template, float)
+    MATH_FO_AUTO_DIFF_TEMPLATES(template, double)
+    MATH_HO_AUTO_DIFF_TEMPLATES(template, double)
+} // namespace math
+
+#endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef MATH_CALCULUS_EXTERN_TEMPLATES_HPP
+#define MATH_CALCULUS_EXTERN_TEMPLATES_HPP
+
+#include "Config.hpp"
+
+#include "FOAutoDiff.hpp"
+#include "HOAutoDiff.hpp"
+
+// prefix is either "extern template" or "template",
+// hidden friends of _high_order_dual_number cannot be named here and are still instantiated per use
+#define MATH_FO_AUTO_DIFF_TEMPLATES(prefix, value_type)                                                                              \
+    prefix struct calculus::details::_dual_number<value_type>;                                                                        \
+    prefix calculus::details::_dual_number<value_type> abs<value_type>(calculus::details::_dual_number<value_type>);                  \
+    prefix calculus::details::_dual_number<value_type> sq<value_type>(calculus::details::_dual_number<value_type>);                   \
+    prefix calculus::details::_dual_number<value_type> cb<value_type>(calculus::details::_dual_number<value_type>);                   \
+    prefix calculus::details::_dual_number<value_type> sqrt<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> cbrt<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> pow<value_type>(calculus::details::_dual_number<value_type>, value_type);      \
+    prefix calculus::details::_dual_number<value_type> pow<value_type>(calculus::details::_dual_number<value_type>);                  \
+    prefix calculus::details::_dual_number<value_type> exp<value_type>(calculus::details::_dual_number<value_type>);                  \
+    prefix calculus::details::_dual_number<value_type> exp_n<value_type>(value_type, calculus::details::_dual_number<value_type>);    \
+    prefix calculus::details::_dual_number<value_type> log<value_type>(calculus::details::_dual_number<value_type>);                  \
+    prefix calculus::details::_dual_number<value_type> ln<value_type>(calculus::details::_dual_number<value_type>);                   \
+    prefix calculus::details::_dual_number<value_type> log_n<value_type>(value_type, calculus::details::_dual_number<value_type>);    \
+    prefix calculus::details::_dual_number<value_type> log_x_n<value_type>(calculus::details::_dual_number<value_type>, value_type);  \
+    prefix calculus::details::_dual_number<value_type> sin<value_type>(calculus::details::_dual_number<value_type>);                  \
+    prefix calculus::details::_dual_number<value_type> cos<value_type>(calculus::details::_dual_number<value_type>);                  \
+    prefix calculus::details::_dual_number<value_type> tan<value_type>(calculus::details::_dual_number<value_type>);                  \
+    prefix calculus::details::_dual_number<value_type> cot<value_type>(calculus::details::_dual_number<value_type>);                  \
+    prefix calculus::details::_dual_number<value_type> sec<value_type>(calculus::details::_dual_number<value_type>);                  \
+    prefix calculus::details::_dual_number<value_type> csc<value_type>(calculus::details::_dual_number<value_type>);                  \
+    prefix calculus::details::_dual_number<value_type> asin<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> acos<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> atan<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> acot<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> asec<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> acsc<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> sinh<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> cosh<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> tanh<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> coth<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> sech<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> csch<value_type>(calculus::details::_dual_number<value_type>);                 \
+    prefix calculus::details::_dual_number<value_type> asinh<value_type>(calculus::details::_dual_number<value_type>);                \
+    prefix calculus::details::_dual_number<value_type> acosh<value_type>(calculus::details::_dual_number<value_type>);                \
+    prefix calculus::details::_dual_number<value_type> atanh<value_type>(calculus::details::_dual_number<value_type>);                \
+    prefix calculus::details::_dual_number<value_type> acoth<value_type>(calculus::details::_dual_number<value_type>);                \
+    prefix calculus::details::_dual_number<value_type> asech<value_type>(calculus::details::_dual_number<value_type>);                \
+    prefix calculus::details::_dual_number<value_type> acsch<value_type>(calculus::details::_dual_number<value_type>);               
+
+#define MATH_HO_AUTO_DIFF_TEMPLATES(prefix, value_type)                                                                              \
+    prefix class calculus::details::_high_order_dual_number<value_type, 1>;                                                           \
+    prefix class calculus::details::_high_order_dual_number<value_type, 2>;                                                           \
+    prefix class calculus::details::_high_order_dual_number<value_type, 3>;                                                           \
+    prefix class calculus::details::_high_order_dual_number<value_type, 4>;                                                           \
+    prefix class calculus::details::_high_order_dual_number<value_type, 5>;                                                           \
+    prefix class calculus::details::_high_order_dual_number<value_type, 6>;                                                           \
+    prefix class calculus::details::_high_order_dual_number<value_type, 7>;                                                           \
+    prefix class calculus::details::_high_order_dual_number<value_type, 8>;                                                           \
+    prefix class calculus::details::_high_order_dual_number<value_type, 9>;                                                           \
+    prefix class calculus::details::_high_order_dual_number<value_type, 10>;                                                          \
+    prefix class calculus::details::_high_order_dual_number<value_type, 11>;                                                          \
+    prefix class calculus::details::_high_order_dual_number<value_type, 12>;                                                          \
+    prefix class calculus::details::_high_order_dual_number<value_type, 13>;                                                          \
+    prefix class calculus::details::_high_order_dual_number<value_type, 14>;                                                          \
+    prefix class calculus::details::_high_order_dual_number<value_type, 15>;                                                          \
+    prefix class calculus::details::_high_order_dual_number<value_type, 16>;                                                         
+
+#if defined(USE_EXTERN_TEMPLATES) && !defined(USE_GLOBAL_FLOATING_POINT_TYPE)
+namespace math
+{
+    MATH_FO_AUTO_DIFF_TEMPLATES(extern template, float)
+    MATH_FO_AUTO_DIFF_TEMPLATES(extern template, double)
+    MATH_HO_AUTO_DIFF_TEMPLATES(extern template, double)
+} // namespace math
+#endif // USE_EXTERN_TEMPLATES
+
+#endif // MATH_CALCULUS_EXTERN_TEMPLATES_HPP
\ No newline at end of file
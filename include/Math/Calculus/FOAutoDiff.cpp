@@ -2,6 +2,27 @@
 
 #ifdef USE_GLOBAL_FLOATING_POINT_TYPE
 #include "FOAutoDiff.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+// ifunc dispatch needs an ELF target, elsewhere the array kernels are built once for the baseline ISA
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__ELF__)
+#define MATH_MULTIVERSION __attribute__((target_clones("default", "sse4.2", "avx2", "avx512f")))
+#else
+#define MATH_MULTIVERSION
+#endif
+
+// kernels bound by a libm call per element, which stays scalar on every instruction set
+#define MATH_DUAL_ARRAY_KERNEL(function)                                         \
+    void function(const calculus::details::_dual_number *x,                      \
+                  calculus::details::_dual_number *result,                       \
+                  size_type count)                                               \
+    {                                                                            \
+        for (size_type i = 0; i < count; ++i)                                    \
+            result[i] = function(x[i]);                                          \
+    }
+
 namespace math
 {
     // x.real != 0
@@ -50,15 +71,28 @@ namespace math
             x.dual / (3.0 * cbrt_xr * cbrt_xr)};
     }
 
-    // x^x or f(x) ^ f(x)
+    // x.real != 0 || y.real != 0
+    calculus::details::_dual_number hypot(calculus::details::_dual_number x, calculus::details::_dual_number y)
+    {
+        auto hypot_xy = std::hypot(x.real, y.real);
+        if (hypot_xy == 0.0)
+            throw std::runtime_error("x.real = y.real = 0 at math::hypot<dual_number>");
+        return calculus::details::_dual_number{
+            hypot_xy,
+            (x.dual * x.real + y.dual * y.real) / hypot_xy};
+    }
+
+    // x^p, the derivative p x^(p - 1) is taken directly: a constant x or p = 0 has a zero tangent,
+    // otherwise x.real = 0 is fine only for natural p >= 1
     calculus::details::_dual_number pow(calculus::details::_dual_number x, math::real p)
     {
-        if (x.real == 0.0)
+        if (p == 0.0 || x.dual == 0.0)
+            return calculus::details::_dual_number{std::pow(x.real, p)};
+        if (x.real == 0.0 && (p < 1.0 || p != std::floor(p)))
             throw std::runtime_error("x.real = 0 at math::pow_x_n<dual_number>");
-        auto pow_xr = std::pow(x.real, p);
         return calculus::details::_dual_number{
-            pow_xr,
-            p * x.dual * pow_xr / x.real};
+            std::pow(x.real, p),
+            p * x.dual * std::pow(x.real, p - 1.0)};
     }
 
     // exponential and logarithmic group
@@ -74,13 +108,23 @@ namespace math
     }
 
     // pow f(x)^g(x)
-    // calculus::details::_dual_number pow(calculus::details::_dual_number x, algebra::dual_numberg_x)
-    // {
-    //     auto xr_pow_xr = std::pow(x.real, x.real);
-    //     return calculus::details::_dual_number{
-    //         xr_pow_xr,
-    //         x.dual * xr_pow_xr * (1 + std::log(x.real))};
-    // }
+    calculus::details::_dual_number pow(calculus::details::_dual_number f, calculus::details::_dual_number g)
+    {
+        auto pow_fg = std::pow(f.real, g.real);
+        math::real dual{};
+        if (f.dual != 0.0)
+            dual = f.real != 0.0
+                       ? f.dual * g.real * pow_fg / f.real
+                       : f.dual * g.real * std::pow(f.real, g.real - 1.0);
+        if (g.dual != 0.0)
+        {
+            if (f.real < 0.0)
+                throw std::runtime_error("f.real < 0 at math::pow_f_g<dual_number>");
+            if (f.real > 0.0)
+                dual += g.dual * pow_fg * std::log(f.real);
+        }
+        return calculus::details::_dual_number{pow_fg, dual};
+    }
 
     calculus::details::_dual_number exp(calculus::details::_dual_number x)
     {
@@ -229,10 +273,21 @@ namespace math
     calculus::details::_dual_number acsc(calculus::details::_dual_number x)
     {
         return calculus::details::_dual_number{
-            std::acos(1.0 / x.real),
+            std::asin(1.0 / x.real),
             -x.dual / (std::abs(x.real) * std::sqrt(x.real * x.real - 1))};
     }
 
+    // angle of (x, y), x.real != 0 || y.real != 0
+    calculus::details::_dual_number atan2(calculus::details::_dual_number y, calculus::details::_dual_number x)
+    {
+        auto r_sq = x.real * x.real + y.real * y.real;
+        if (r_sq == 0.0)
+            throw std::runtime_error("x.real = y.real = 0 at math::atan2<dual_number>");
+        return calculus::details::_dual_number{
+            std::atan2(y.real, x.real),
+            (x.real * y.dual - y.real * x.dual) / r_sq};
+    }
+
     // hyperbolic group
 
     calculus::details::_dual_number sinh(calculus::details::_dual_number x)
@@ -285,46 +340,433 @@ namespace math
     {
         return calculus::details::_dual_number{
             std::asinh(x.real),
-            x.dual * std::sqrt(1.0 + x.real * x.real)};
+            x.dual / std::sqrt(1.0 + x.real * x.real)};
     }
 
     calculus::details::_dual_number acosh(calculus::details::_dual_number x)
     {
         return calculus::details::_dual_number{
             std::acosh(x.real),
-            x.dual * std::sqrt(x.real * x.real - 1.0)};
+            x.dual / std::sqrt(x.real * x.real - 1.0)};
     }
 
     calculus::details::_dual_number atanh(calculus::details::_dual_number x)
     {
         return calculus::details::_dual_number{
             std::atanh(x.real),
-            x.dual * (1.0 - x.real * x.real)};
+            x.dual / (1.0 - x.real * x.real)};
     }
 
     calculus::details::_dual_number acoth(calculus::details::_dual_number x)
     {
         return calculus::details::_dual_number{
             std::atanh(1.0 / x.real),
-            x.dual * (1.0 - x.real * x.real)};
+            x.dual / (1.0 - x.real * x.real)};
     }
 
     calculus::details::_dual_number asech(calculus::details::_dual_number x)
     {
         return calculus::details::_dual_number{
             std::acosh(1.0 / x.real),
-            -x.dual * x.real * std::sqrt(1.0 - x.real * x.real)};
+            -x.dual / (x.real * std::sqrt(1.0 - x.real * x.real))};
     }
 
     calculus::details::_dual_number acsch(calculus::details::_dual_number x)
     {
         return calculus::details::_dual_number{
-            std::acosh(1.0 / x.real),
-            -x.dual * std::abs(x.real) * std::sqrt(1.0 + x.real * x.real)};
+            std::asinh(1.0 / x.real),
+            -x.dual / (std::abs(x.real) * std::sqrt(1.0 + x.real * x.real))};
     }
 
     // miscellaneous group
 
+    // x * y + z with a single rounding of the value
+    calculus::details::_dual_number fma(calculus::details::_dual_number x, calculus::details::_dual_number y, calculus::details::_dual_number z)
+    {
+        return calculus::details::_dual_number{
+            std::fma(x.real, y.real, z.real),
+            x.dual * y.real + x.real * y.dual + z.dual};
+    }
+
+    // ties take the tangent of x, a NaN operand yields the other one as in std::fmin
+    calculus::details::_dual_number fmin(calculus::details::_dual_number x, calculus::details::_dual_number y)
+    {
+        return (y.real < x.real || std::isnan(x.real)) ? y : x;
+    }
+
+    calculus::details::_dual_number fmax(calculus::details::_dual_number x, calculus::details::_dual_number y)
+    {
+        return (y.real > x.real || std::isnan(x.real)) ? y : x;
+    }
+
+    // activation group, value and tangent share one exp and never overflow
+
+    calculus::details::_dual_number sigmoid(calculus::details::_dual_number x)
+    {
+        math::real e = std::exp(-std::abs(x.real));
+        math::real inv = 1.0 / (1.0 + e);
+        return calculus::details::_dual_number{
+            (x.real >= 0.0 ? 1.0 : e) * inv,
+            x.dual * e * inv * inv};
+    }
+
+    calculus::details::_dual_number softplus(calculus::details::_dual_number x)
+    {
+        math::real e = std::exp(-std::abs(x.real));
+        math::real s = (x.real >= 0.0 ? 1.0 : e) / (1.0 + e);
+        return calculus::details::_dual_number{
+            std::fmax(x.real, 0.0) + std::log1p(e),
+            x.dual * s};
+    }
+
+    calculus::details::_dual_number relu(calculus::details::_dual_number x)
+    {
+        return x.real > 0.0 ? x : calculus::details::_dual_number{0.0};
+    }
+
+    calculus::details::_dual_number leaky_relu(calculus::details::_dual_number x, math::real slope)
+    {
+        return x.real > 0.0 ? x : calculus::details::_dual_number{slope * x.real, slope * x.dual};
+    }
+
+    calculus::details::_dual_number logsumexp(const calculus::details::_dual_number *x, size_type count)
+    {
+        math::real shift = -std::numeric_limits<math::real>::infinity();
+        for (size_type i = 0; i < count; ++i)
+            shift = std::fmax(shift, x[i].real);
+        if (count == 0)
+            return calculus::details::_dual_number{shift};
+
+        math::real sum = 0.0, tangent = 0.0;
+        for (size_type i = 0; i < count; ++i)
+        {
+            math::real e = calculus::details::_shifted_exp(x[i].real, shift);
+            sum += e;
+            tangent += e * x[i].dual;
+        }
+        return calculus::details::_dual_number{std::isinf(shift) ? shift : shift + std::log(sum), tangent / sum};
+    }
+
+    void softmax(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count)
+    {
+        math::real shift = -std::numeric_limits<math::real>::infinity();
+        for (size_type i = 0; i < count; ++i)
+            shift = std::fmax(shift, x[i].real);
+
+        math::real sum = 0.0, tangent = 0.0;
+        for (size_type i = 0; i < count; ++i)
+        {
+            math::real e = calculus::details::_shifted_exp(x[i].real, shift);
+            sum += e;
+            tangent += e * x[i].dual;
+            result[i].real = e;
+        }
+        math::real inv = 1.0 / sum;
+        tangent *= inv;
+        for (size_type i = 0; i < count; ++i)
+        {
+            result[i].real *= inv;
+            result[i].dual = result[i].real * (x[i].dual - tangent);
+        }
+    }
+
+    // polynomial group, the tangent is p'(x) x' with p' summed next to p, no dual arithmetic per term
+
+    calculus::details::_dual_number polyval(const math::real *coefficients, size_type count, calculus::details::_dual_number x)
+    {
+        math::real p, dp;
+        calculus::details::_polynomial_and_derivative(coefficients, count, x.real, p, dp);
+        return calculus::details::_dual_number{p, dp * x.dual};
+    }
+
+    // p(x) / q(x) with one division for the value and the tangent
+    calculus::details::_dual_number ratval(const math::real *numerator, size_type numerator_count,
+                                           const math::real *denominator, size_type denominator_count,
+                                           calculus::details::_dual_number x)
+    {
+        math::real p, dp, q, dq;
+        calculus::details::_polynomial_and_derivative(numerator, numerator_count, x.real, p, dp);
+        calculus::details::_polynomial_and_derivative(denominator, denominator_count, x.real, q, dq);
+        math::real inv = 1.0 / q;
+        return calculus::details::_dual_number{p * inv, (dp - p * inv * dq) * inv * x.dual};
+    }
+
+    // mixed group, a plain argument is a constant and costs no tangent arithmetic
+
+    // b^x, b >= 0 unless x carries no tangent
+    calculus::details::_dual_number pow(math::real b, calculus::details::_dual_number x)
+    {
+        auto pow_bx = std::pow(b, x.real);
+        math::real dual{};
+        if (x.dual != 0.0)
+        {
+            if (b < 0.0)
+                throw std::runtime_error("b < 0 at math::pow_b_x<dual_number>");
+            if (b > 0.0)
+                dual = x.dual * pow_bx * std::log(b);
+        }
+        return calculus::details::_dual_number{pow_bx, dual};
+    }
+
+    calculus::details::_dual_number hypot(calculus::details::_dual_number x, math::real y)
+    {
+        auto hypot_xy = std::hypot(x.real, y);
+        if (hypot_xy == 0.0)
+            throw std::runtime_error("x = y = 0 at math::hypot<dual_number>");
+        return calculus::details::_dual_number{
+            hypot_xy,
+            x.dual * x.real / hypot_xy};
+    }
+
+    calculus::details::_dual_number hypot(math::real x, calculus::details::_dual_number y)
+    {
+        auto hypot_xy = std::hypot(x, y.real);
+        if (hypot_xy == 0.0)
+            throw std::runtime_error("x = y = 0 at math::hypot<dual_number>");
+        return calculus::details::_dual_number{
+            hypot_xy,
+            y.dual * y.real / hypot_xy};
+    }
+
+    calculus::details::_dual_number atan2(calculus::details::_dual_number y, math::real x)
+    {
+        auto r_sq = x * x + y.real * y.real;
+        if (r_sq == 0.0)
+            throw std::runtime_error("x = y = 0 at math::atan2<dual_number>");
+        return calculus::details::_dual_number{
+            std::atan2(y.real, x),
+            x * y.dual / r_sq};
+    }
+
+    calculus::details::_dual_number atan2(math::real y, calculus::details::_dual_number x)
+    {
+        auto r_sq = x.real * x.real + y * y;
+        if (r_sq == 0.0)
+            throw std::runtime_error("x = y = 0 at math::atan2<dual_number>");
+        return calculus::details::_dual_number{
+            std::atan2(y, x.real),
+            -y * x.dual / r_sq};
+    }
+
+    calculus::details::_dual_number fma(calculus::details::_dual_number x, calculus::details::_dual_number y, math::real z)
+    {
+        return calculus::details::_dual_number{
+            std::fma(x.real, y.real, z),
+            x.dual * y.real + x.real * y.dual};
+    }
+
+    calculus::details::_dual_number fma(calculus::details::_dual_number x, math::real y, calculus::details::_dual_number z)
+    {
+        return calculus::details::_dual_number{
+            std::fma(x.real, y, z.real),
+            x.dual * y + z.dual};
+    }
+
+    calculus::details::_dual_number fma(math::real x, calculus::details::_dual_number y, calculus::details::_dual_number z)
+    {
+        return calculus::details::_dual_number{
+            std::fma(x, y.real, z.real),
+            x * y.dual + z.dual};
+    }
+
+    calculus::details::_dual_number fma(calculus::details::_dual_number x, math::real y, math::real z)
+    {
+        return calculus::details::_dual_number{
+            std::fma(x.real, y, z),
+            x.dual * y};
+    }
+
+    calculus::details::_dual_number fma(math::real x, calculus::details::_dual_number y, math::real z)
+    {
+        return calculus::details::_dual_number{
+            std::fma(x, y.real, z),
+            x * y.dual};
+    }
+
+    calculus::details::_dual_number fma(math::real x, math::real y, calculus::details::_dual_number z)
+    {
+        return calculus::details::_dual_number{
+            std::fma(x, y, z.real),
+            z.dual};
+    }
+
+    calculus::details::_dual_number fmin(calculus::details::_dual_number x, math::real y)
+    {
+        return (y < x.real || std::isnan(x.real)) ? calculus::details::_dual_number{y} : x;
+    }
+
+    calculus::details::_dual_number fmin(math::real x, calculus::details::_dual_number y)
+    {
+        return (y.real < x || std::isnan(x)) ? y : calculus::details::_dual_number{x};
+    }
+
+    calculus::details::_dual_number fmax(calculus::details::_dual_number x, math::real y)
+    {
+        return (y > x.real || std::isnan(x.real)) ? calculus::details::_dual_number{y} : x;
+    }
+
+    calculus::details::_dual_number fmax(math::real x, calculus::details::_dual_number y)
+    {
+        return (y.real > x || std::isnan(x)) ? y : calculus::details::_dual_number{x};
+    }
+
+    // y may alias x
+    void axpy(math::real a, const calculus::details::_dual_number &x, calculus::details::_dual_number &y) noexcept
+    {
+        y.real += a * x.real;
+        y.dual += a * x.dual;
+    }
+
+    // the tangent is accumulated first so that y may alias a or x
+    void axpy(const calculus::details::_dual_number &a, const calculus::details::_dual_number &x, calculus::details::_dual_number &y) noexcept
+    {
+        y.dual += a.real * x.dual + a.dual * x.real;
+        y.real += a.real * x.real;
+    }
+
+    // array-wide kernels
+
+    // the arithmetic ones are written out in the loop body so that every clone vectorizes it (the library
+    // is built with -fno-math-errno and -fno-trapping-math so that std::sqrt and the selects qualify),
+    // domain checks run as a separate pass and throw before anything is written
+
+    MATH_MULTIVERSION void abs(const calculus::details::_dual_number *x,
+                               calculus::details::_dual_number *result, size_type count)
+    {
+        bool zero = false;
+        for (size_type i = 0; i < count; ++i)
+            zero |= x[i].real == 0.0;
+        if (zero)
+            throw std::runtime_error("x.real = 0 at math::abs<dual_number>");
+        for (size_type i = 0; i < count; ++i)
+        {
+            math::real xr = x[i].real, xd = x[i].dual;
+            result[i].real = xr < 0.0 ? -xr : xr;
+            result[i].dual = xr < 0.0 ? -xd : xd;
+        }
+    }
+
+    MATH_MULTIVERSION void sq(const calculus::details::_dual_number *x,
+                              calculus::details::_dual_number *result, size_type count)
+    {
+        for (size_type i = 0; i < count; ++i)
+        {
+            math::real xr = x[i].real, xd = x[i].dual;
+            result[i].real = xr * xr;
+            result[i].dual = xd * 2.0 * xr;
+        }
+    }
+
+    MATH_MULTIVERSION void cb(const calculus::details::_dual_number *x,
+                              calculus::details::_dual_number *result, size_type count)
+    {
+        for (size_type i = 0; i < count; ++i)
+        {
+            math::real xr = x[i].real, xd = x[i].dual;
+            result[i].real = xr * xr * xr;
+            result[i].dual = xd * 3.0 * xr * xr;
+        }
+    }
+
+    MATH_MULTIVERSION void sqrt(const calculus::details::_dual_number *x,
+                                calculus::details::_dual_number *result, size_type count)
+    {
+        bool outside = false;
+        for (size_type i = 0; i < count; ++i)
+            outside |= !(x[i].real > 0.0);
+        if (outside)
+            throw std::runtime_error("x.real <= 0 at math::sqrt<dual_number>");
+        for (size_type i = 0; i < count; ++i)
+        {
+            math::real sqrt_xr = std::sqrt(x[i].real), xd = x[i].dual;
+            result[i].real = sqrt_xr;
+            result[i].dual = xd * (0.5 / sqrt_xr);
+        }
+    }
+
+    MATH_MULTIVERSION void relu(const calculus::details::_dual_number *x,
+                                calculus::details::_dual_number *result, size_type count)
+    {
+        for (size_type i = 0; i < count; ++i)
+        {
+            math::real xr = x[i].real, xd = x[i].dual;
+            result[i].real = xr > 0.0 ? xr : 0.0;
+            result[i].dual = xr > 0.0 ? xd : 0.0;
+        }
+    }
+
+    MATH_MULTIVERSION void leaky_relu(const calculus::details::_dual_number *x, math::real slope,
+                                      calculus::details::_dual_number *result, size_type count)
+    {
+        for (size_type i = 0; i < count; ++i)
+        {
+            math::real xr = x[i].real, xd = x[i].dual;
+            result[i].real = xr > 0.0 ? xr : slope * xr;
+            result[i].dual = xr > 0.0 ? xd : slope * xd;
+        }
+    }
+
+    MATH_DUAL_ARRAY_KERNEL(cbrt)
+    MATH_DUAL_ARRAY_KERNEL(exp)
+    MATH_DUAL_ARRAY_KERNEL(log)
+    MATH_DUAL_ARRAY_KERNEL(ln)
+    MATH_DUAL_ARRAY_KERNEL(sin)
+    MATH_DUAL_ARRAY_KERNEL(cos)
+    MATH_DUAL_ARRAY_KERNEL(tan)
+    MATH_DUAL_ARRAY_KERNEL(cot)
+    MATH_DUAL_ARRAY_KERNEL(sec)
+    MATH_DUAL_ARRAY_KERNEL(csc)
+    MATH_DUAL_ARRAY_KERNEL(asin)
+    MATH_DUAL_ARRAY_KERNEL(acos)
+    MATH_DUAL_ARRAY_KERNEL(atan)
+    MATH_DUAL_ARRAY_KERNEL(acot)
+    MATH_DUAL_ARRAY_KERNEL(asec)
+    MATH_DUAL_ARRAY_KERNEL(acsc)
+    MATH_DUAL_ARRAY_KERNEL(sinh)
+    MATH_DUAL_ARRAY_KERNEL(cosh)
+    MATH_DUAL_ARRAY_KERNEL(tanh)
+    MATH_DUAL_ARRAY_KERNEL(coth)
+    MATH_DUAL_ARRAY_KERNEL(sech)
+    MATH_DUAL_ARRAY_KERNEL(csch)
+    MATH_DUAL_ARRAY_KERNEL(asinh)
+    MATH_DUAL_ARRAY_KERNEL(acosh)
+    MATH_DUAL_ARRAY_KERNEL(atanh)
+    MATH_DUAL_ARRAY_KERNEL(acoth)
+    MATH_DUAL_ARRAY_KERNEL(asech)
+    MATH_DUAL_ARRAY_KERNEL(acsch)
+    MATH_DUAL_ARRAY_KERNEL(sigmoid)
+    MATH_DUAL_ARRAY_KERNEL(softplus)
+
+    void pow(const calculus::details::_dual_number *x, math::real p,
+             calculus::details::_dual_number *result, size_type count)
+    {
+        for (size_type i = 0; i < count; ++i)
+            result[i] = pow(x[i], p);
+    }
+
+    void exp_n(math::real n, const calculus::details::_dual_number *x,
+               calculus::details::_dual_number *result, size_type count)
+    {
+        for (size_type i = 0; i < count; ++i)
+            result[i] = exp_n(n, x[i]);
+    }
+
+    void log_n(math::real n, const calculus::details::_dual_number *x,
+               calculus::details::_dual_number *result, size_type count)
+    {
+        for (size_type i = 0; i < count; ++i)
+            result[i] = log_n(n, x[i]);
+    }
+
+    void log_x_n(const calculus::details::_dual_number *x, math::real n,
+                 calculus::details::_dual_number *result, size_type count)
+    {
+        for (size_type i = 0; i < count; ++i)
+            result[i] = log_x_n(x[i], n);
+    }
 }; // namespace math
 
+#undef MATH_DUAL_ARRAY_KERNEL
+#undef MATH_MULTIVERSION
+
 #endif
\ No newline at end of file
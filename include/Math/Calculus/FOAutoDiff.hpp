@@ -3,7 +3,10 @@
 
 #include "Config.hpp"
 
+#include "Utility/ScalarTraits.hpp"
+
 #include <iostream>
+#include <limits>
 #include <type_traits>
 #include <cmath>
 
@@ -27,64 +30,123 @@ namespace math
             _dual_number &operator=(_dual_number &&rhs) = default;
             ~_dual_number() = default;
 
-            _dual_number operator+(_dual_number rhs)
+            _dual_number &operator+=(const _dual_number &rhs) noexcept
+            {
+                real += rhs.real;
+                dual += rhs.dual;
+                return *this;
+            }
+
+            _dual_number &operator+=(math::real scalar) noexcept
+            {
+                real += scalar;
+                return *this;
+            }
+
+            _dual_number &operator-=(const _dual_number &rhs) noexcept
+            {
+                real -= rhs.real;
+                dual -= rhs.dual;
+                return *this;
+            }
+
+            _dual_number &operator-=(math::real scalar) noexcept
+            {
+                real -= scalar;
+                return *this;
+            }
+
+            _dual_number &operator*=(const _dual_number &rhs) noexcept
+            {
+                dual = dual * rhs.real + real * rhs.dual;
+                real *= rhs.real;
+                return *this;
+            }
+
+            _dual_number &operator*=(math::real scalar) noexcept
+            {
+                real *= scalar;
+                dual *= scalar;
+                return *this;
+            }
+
+            _dual_number &operator/=(const _dual_number &rhs) noexcept
+            {
+                dual = (dual * rhs.real - real * rhs.dual) / (rhs.real * rhs.real);
+                real /= rhs.real;
+                return *this;
+            }
+
+            _dual_number &operator/=(math::real scalar) noexcept
+            {
+                real /= scalar;
+                dual /= scalar;
+                return *this;
+            }
+
+            _dual_number operator-() const noexcept
+            {
+                return _dual_number{-real, -dual};
+            }
+
+            _dual_number operator+(const _dual_number &rhs) const noexcept
             {
                 return _dual_number{real + rhs.real, dual + rhs.dual};
             }
 
-            _dual_number operator+(math::real scalar)
+            _dual_number operator+(math::real scalar) const noexcept
             {
                 return _dual_number{real + scalar, dual};
             }
 
-            friend _dual_number operator+(math::real scalar, _dual_number num)
+            friend _dual_number operator+(math::real scalar, const _dual_number &num) noexcept
             {
                 return _dual_number{num.real + scalar, num.dual};
             }
 
-            _dual_number operator-(_dual_number rhs)
+            _dual_number operator-(const _dual_number &rhs) const noexcept
             {
                 return _dual_number{real - rhs.real, dual - rhs.dual};
             }
 
-            _dual_number operator-(math::real scalar)
+            _dual_number operator-(math::real scalar) const noexcept
             {
                 return _dual_number{real - scalar, dual};
             }
 
-            friend _dual_number operator-(math::real scalar, _dual_number d_num)
+            friend _dual_number operator-(math::real scalar, const _dual_number &d_num) noexcept
             {
                 return _dual_number{scalar - d_num.real, -d_num.dual};
             }
 
-            _dual_number operator*(_dual_number rhs)
+            _dual_number operator*(const _dual_number &rhs) const noexcept
             {
                 return _dual_number{real * rhs.real, real * rhs.dual + dual * rhs.real};
             }
 
-            _dual_number operator*(math::real rhs)
+            _dual_number operator*(math::real rhs) const noexcept
             {
                 return _dual_number{real * rhs, dual * rhs};
             }
 
-            friend _dual_number operator*(math::real scalar, _dual_number d_num)
+            friend _dual_number operator*(math::real scalar, const _dual_number &d_num) noexcept
             {
                 return _dual_number{d_num.real * scalar, d_num.dual * scalar};
             }
 
-            _dual_number operator/(_dual_number rhs)
+            _dual_number operator/(const _dual_number &rhs) const noexcept
             {
                 return _dual_number{
                     real / rhs.real,
                     (dual * rhs.real - real * rhs.dual) / (rhs.real * rhs.real)};
             }
 
-            _dual_number operator/(math::real rhs)
+            _dual_number operator/(math::real rhs) const noexcept
             {
                 return _dual_number{real / rhs, dual / rhs};
             }
 
-            friend _dual_number operator/(math::real scalar, _dual_number d_num)
+            friend _dual_number operator/(math::real scalar, const _dual_number &d_num) noexcept
             {
                 return _dual_number{
                     scalar / d_num.real,
@@ -100,7 +162,7 @@ namespace math
         template <typename value_type = math::real>
         struct _dual_number
         {
-            static_assert(std::is_floating_point<value_type>::value);
+            static_assert(utility::scalar_traits<value_type>::is_scalar, "_dual_number needs a scalar value type");
 
             value_type real;
             value_type dual;
@@ -109,6 +171,13 @@ namespace math
 
             _dual_number(value_type r, value_type d = value_type{}) : real{r}, dual(d) {}
 
+            // float instances are built from double intermediates without narrowing
+            template <typename real_tp, typename dual_tp,
+                      typename = std::enable_if_t<std::is_arithmetic<real_tp>::value &&
+                                                  std::is_arithmetic<dual_tp>::value>>
+            _dual_number(real_tp r, dual_tp d)
+                : real{static_cast<value_type>(r)}, dual(static_cast<value_type>(d)) {}
+
             _dual_number() = default;
             _dual_number(const _dual_number &rhs) = default;
             _dual_number(_dual_number &&rhs) = default;
@@ -117,68 +186,130 @@ namespace math
             ~_dual_number() = default;
 
             template <typename rhs_value_type>
-            _dual_number operator+(_dual_number<rhs_value_type> rhs)
+            _dual_number &operator+=(const _dual_number<rhs_value_type> &rhs) noexcept
+            {
+                real += rhs.real;
+                dual += rhs.dual;
+                return *this;
+            }
+
+            _dual_number &operator+=(value_type scalar) noexcept
+            {
+                real += scalar;
+                return *this;
+            }
+
+            template <typename rhs_value_type>
+            _dual_number &operator-=(const _dual_number<rhs_value_type> &rhs) noexcept
+            {
+                real -= rhs.real;
+                dual -= rhs.dual;
+                return *this;
+            }
+
+            _dual_number &operator-=(value_type scalar) noexcept
+            {
+                real -= scalar;
+                return *this;
+            }
+
+            template <typename rhs_value_type>
+            _dual_number &operator*=(const _dual_number<rhs_value_type> &rhs) noexcept
+            {
+                dual = dual * rhs.real + real * rhs.dual;
+                real *= rhs.real;
+                return *this;
+            }
+
+            _dual_number &operator*=(value_type scalar) noexcept
+            {
+                real *= scalar;
+                dual *= scalar;
+                return *this;
+            }
+
+            template <typename rhs_value_type>
+            _dual_number &operator/=(const _dual_number<rhs_value_type> &rhs) noexcept
+            {
+                dual = (dual * rhs.real - real * rhs.dual) / (rhs.real * rhs.real);
+                real /= rhs.real;
+                return *this;
+            }
+
+            _dual_number &operator/=(value_type scalar) noexcept
+            {
+                real /= scalar;
+                dual /= scalar;
+                return *this;
+            }
+
+            _dual_number operator-() const noexcept
+            {
+                return _dual_number{-real, -dual};
+            }
+
+            template <typename rhs_value_type>
+            _dual_number operator+(const _dual_number<rhs_value_type> &rhs) const noexcept
             {
                 return _dual_number{real + rhs.real, dual + rhs.dual};
             }
 
-            _dual_number operator+(value_type scalar)
+            _dual_number operator+(value_type scalar) const noexcept
             {
                 return _dual_number{real + scalar, dual};
             }
 
-            friend _dual_number operator+(value_type scalar, _dual_number num)
+            friend _dual_number operator+(value_type scalar, const _dual_number &num) noexcept
             {
                 return _dual_number{num.real + scalar, num.dual};
             }
 
             template <typename rhs_value_type>
-            _dual_number operator-(_dual_number<rhs_value_type> rhs)
+            _dual_number operator-(const _dual_number<rhs_value_type> &rhs) const noexcept
             {
                 return _dual_number{real - rhs.real, dual - rhs.dual};
             }
 
-            _dual_number operator-(value_type scalar)
+            _dual_number operator-(value_type scalar) const noexcept
             {
                 return _dual_number{real - scalar, dual};
             }
 
-            template <typename rhs_value_type>
-            friend _dual_number operator-(value_type scalar, _dual_number<rhs_value_type> d_num)
+            friend _dual_number operator-(value_type scalar, const _dual_number &d_num) noexcept
             {
                 return _dual_number{scalar - d_num.real, -d_num.dual};
             }
 
             template <typename rhs_value_type>
-            _dual_number operator*(_dual_number<rhs_value_type> rhs)
+            _dual_number operator*(const _dual_number<rhs_value_type> &rhs) const noexcept
             {
                 return _dual_number{real * rhs.real, real * rhs.dual + dual * rhs.real};
             }
 
-            _dual_number operator*(value_type rhs)
+            _dual_number operator*(value_type rhs) const noexcept
             {
                 return _dual_number{real * rhs, dual * rhs};
             }
 
-            friend _dual_number operator*(value_type scalar, _dual_number d_num)
+            friend _dual_number operator*(value_type scalar, const _dual_number &d_num) noexcept
             {
                 return _dual_number{d_num.real * scalar, d_num.dual * scalar};
             }
 
             template <typename rhs_value_type>
-            _dual_number operator/(_dual_number<rhs_value_type> rhs)
+            _dual_number operator/(const _dual_number<rhs_value_type> &rhs) const noexcept
             {
                 return _dual_number{
                     real / rhs.real,
                     (dual * rhs.real - real * rhs.dual) / (rhs.real * rhs.real)};
             }
 
-            _dual_number operator/(math::real rhs)
+            _dual_number operator/(math::real rhs) const noexcept
             {
                 return _dual_number{real / rhs, dual / rhs};
             }
 
-            friend _dual_number operator/(math::real scalar, _dual_number d_num)
+            friend _dual_number operator/(math::real scalar, const _dual_number &d_num) noexcept
             {
                 return _dual_number{
                     scalar / d_num.real,
@@ -192,6 +323,269 @@ namespace math
         };
 #endif // USE_GLOBAL_FLOATING_POINT_TYPE
     }  // namespace math::algebra
+
+    namespace calculus::details
+    {
+        // x^n by repeated squaring, log2(n) products
+        template <unsigned int n>
+        struct _natural_power
+        {
+            template <typename var_type>
+            static var_type apply(const var_type &x)
+            {
+                var_type half = _natural_power<n / 2>::apply(x);
+                return n % 2 == 1 ? half * half * x : half * half;
+            }
+        };
+
+        template <>
+        struct _natural_power<1>
+        {
+            template <typename var_type>
+            static var_type apply(const var_type &x) { return x; }
+        };
+
+        // only scalars reach the empty product
+        template <>
+        struct _natural_power<0>
+        {
+            template <typename var_type>
+            static var_type apply(const var_type &) { return var_type(1.0); }
+        };
+
+        // sum coefficient(k) * x^k for k < count as even(x^2) + x * odd(x^2),
+        // two independent Horner chains of half the length
+        template <typename var_type, typename coefficient_tp>
+        var_type _even_odd_horner(coefficient_tp coefficient, size_type count, var_type x)
+        {
+            var_type x2 = x * x, even = 0.0, odd = 0.0;
+            size_type i = count;
+            if (i % 2 == 1)
+                even = coefficient(--i);
+            while (i > 0)
+            {
+                i -= 2;
+                odd = odd * x2 + coefficient(i + 1);
+                even = even * x2 + coefficient(i);
+            }
+            return even + x * odd;
+        }
+
+        // the softmax weight e^(x - shift) for the largest x as shift; an infinite shift is the limit
+        // where only the x equal to it carry weight, all alike, so -inf everywhere weighs every x the same
+        template <typename var_type>
+        var_type _shifted_exp(var_type x, var_type shift)
+        {
+            if (isinf(shift))
+                return x == shift ? var_type(1.0) : var_type(0.0);
+            return exp(x - shift);
+        }
+
+        // p(x) and p'(x) for p = sum coefficients[k] x^k, k < count
+        template <typename var_type>
+        void _polynomial_and_derivative(const var_type *coefficients, size_type count, var_type x,
+                                        var_type &value, var_type &derivative)
+        {
+            value = _even_odd_horner([coefficients](size_type k) { return coefficients[k]; }, count, x);
+            derivative = count < 2 ? var_type{}
+                                   : _even_odd_horner([coefficients](size_type k) { return (k + 1) * coefficients[k + 1]; },
+                                                      count - 1, x);
+        }
+    } // namespace math::calculus::details
+
+    template <typename var_type>
+    using _floating_point_t = std::enable_if_t<utility::scalar_traits<var_type>::is_scalar, var_type>;
+
+    template <typename var_type>
+    _floating_point_t<var_type> sq(var_type x)
+    {
+        return x * x;
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> cb(var_type x)
+    {
+        return x * x * x;
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> pow(var_type x)
+    {
+        return pow(x, x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> ln(var_type x)
+    {
+        return log(x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> cot(var_type x)
+    {
+        return 1.0 / tan(x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> sec(var_type x)
+    {
+        return 1.0 / cos(x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> csc(var_type x)
+    {
+        return 1.0 / sin(x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> acot(var_type x)
+    {
+        return atan(1.0 / x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> asec(var_type x)
+    {
+        return acos(1.0 / x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> acsc(var_type x)
+    {
+        return asin(1.0 / x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> coth(var_type x)
+    {
+        return 1.0 / tanh(x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> sech(var_type x)
+    {
+        return 1.0 / cosh(x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> csch(var_type x)
+    {
+        return 1.0 / sinh(x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> acoth(var_type x)
+    {
+        return atanh(1.0 / x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> asech(var_type x)
+    {
+        return acosh(1.0 / x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> acsch(var_type x)
+    {
+        return asinh(1.0 / x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> exp_n(var_type n, var_type x)
+    {
+        return pow(n, x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> log_n(var_type n, var_type x)
+    {
+        return log(x) / log(n);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> log_x_n(var_type x, var_type n)
+    {
+        return log(n) / log(x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> sigmoid(var_type x)
+    {
+        var_type e = exp(-abs(x));
+        return (x >= 0.0 ? 1.0 : e) / (1.0 + e);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> softplus(var_type x)
+    {
+        return fmax(x, 0.0) + log1p(exp(-abs(x)));
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> relu(var_type x)
+    {
+        return x > 0.0 ? x : var_type{};
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> leaky_relu(var_type x, var_type slope)
+    {
+        return x > 0.0 ? x : slope * x;
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> logsumexp(const var_type *x, size_type count)
+    {
+        var_type shift = -std::numeric_limits<var_type>::infinity();
+        for (size_type i = 0; i < count; ++i)
+            shift = fmax(shift, x[i]);
+        if (isinf(shift))
+            return shift;
+        var_type sum = 0.0;
+        for (size_type i = 0; i < count; ++i)
+            sum += exp(x[i] - shift);
+        return shift + log(sum);
+    }
+
+    // x^n for a compile-time n != 0 by repeated squaring, for every type with * and scalar / type
+    template <int n, typename var_type>
+    var_type ipow(const var_type &x)
+    {
+        static_assert(n != 0, "ipow<0> is the constant 1");
+        return n > 0 ? calculus::details::_natural_power<(n > 0 ? n : 1)>::apply(x)
+                     : 1.0 / calculus::details::_natural_power<(n < 0 ? -n : 1)>::apply(x);
+    }
+
+    // sum coefficients[k] * x^k for k < count
+    template <typename var_type>
+    _floating_point_t<var_type> polyval(const var_type *coefficients, size_type count, var_type x)
+    {
+        return calculus::details::_even_odd_horner([coefficients](size_type k) { return coefficients[k]; }, count, x);
+    }
+
+    template <typename var_type>
+    _floating_point_t<var_type> ratval(const var_type *numerator, size_type numerator_count,
+                                       const var_type *denominator, size_type denominator_count, var_type x)
+    {
+        return polyval(numerator, numerator_count, x) / polyval(denominator, denominator_count, x);
+    }
+
+    template <typename var_type>
+    std::enable_if_t<utility::scalar_traits<var_type>::is_scalar> softmax(const var_type *x, var_type *result, size_type count)
+    {
+        var_type shift = -std::numeric_limits<var_type>::infinity();
+        for (size_type i = 0; i < count; ++i)
+            shift = fmax(shift, x[i]);
+        var_type sum = 0.0;
+        for (size_type i = 0; i < count; ++i)
+            sum += (result[i] = calculus::details::_shifted_exp(x[i], shift));
+        var_type inv = 1.0 / sum;
+        for (size_type i = 0; i < count; ++i)
+            result[i] *= inv;
+    }
+
 #ifndef USE_GLOBAL_FLOATING_POINT_TYPE
     // x.real != 0
     template <typename var_type>
@@ -200,8 +594,8 @@ namespace math
         if (x.real == 0.0)
             throw std::runtime_error("x.real = 0 at math::abs<_dual_number>");
         return calculus::details::_dual_number<var_type>{
-            std::abs(x.real),
-            x.dual * x.real / std::abs(x.real)};
+            abs(x.real),
+            x.dual * x.real / abs(x.real)};
     }
 
     // power group
@@ -227,7 +621,7 @@ namespace math
     {
         if (x.real <= 0.0)
             throw std::runtime_error("x.real <= 0 at math::sqrt<_dual_number>");
-        auto sqrt_xr = std::sqrt(x.real);
+        auto sqrt_xr = sqrt(x.real);
         return calculus::details::_dual_number<var_type>{
             sqrt_xr,
             x.dual * (0.5 / sqrt_xr)};
@@ -238,22 +632,36 @@ namespace math
     {
         if (x.real == 0.0)
             throw std::runtime_error("x.real = 0 at math::cbrt<_dual_number>");
-        auto cbrt_xr = std::cbrt(x.real);
+        auto cbrt_xr = cbrt(x.real);
         return calculus::details::_dual_number<var_type>{
             cbrt_xr,
             x.dual / (3.0 * cbrt_xr * cbrt_xr)};
     }
 
-    // x^x or f(x) ^ f(x)
+    // x.real != 0 || y.real != 0
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> hypot(calculus::details::_dual_number<var_type> x, calculus::details::_dual_number<var_type> y)
+    {
+        auto hypot_xy = hypot(x.real, y.real);
+        if (hypot_xy == 0.0)
+            throw std::runtime_error("x.real = y.real = 0 at math::hypot<_dual_number>");
+        return calculus::details::_dual_number<var_type>{
+            hypot_xy,
+            (x.dual * x.real + y.dual * y.real) / hypot_xy};
+    }
+
+    // x^p, the derivative p x^(p - 1) is taken directly: a constant x or p = 0 has a zero tangent,
+    // otherwise x.real = 0 is fine only for natural p >= 1
     template <typename var_type>
     calculus::details::_dual_number<var_type> pow(calculus::details::_dual_number<var_type> x, var_type p)
     {
-        if (x.real == 0.0)
+        if (p == 0.0 || x.dual == 0.0)
+            return calculus::details::_dual_number<var_type>{pow(x.real, p)};
+        if (x.real == 0.0 && (p < 1.0 || p != floor(p)))
             throw std::runtime_error("x.real = 0 at math::pow_x_n<_dual_number>");
-        auto pow_xr = std::pow(x.real, p);
         return calculus::details::_dual_number<var_type>{
-            pow_xr,
-            p * x.dual * pow_xr / x.real};
+            pow(x.real, p),
+            p * x.dual * pow(x.real, p - 1.0)};
     }
 
     // exponential and logarithmic group
@@ -263,26 +671,37 @@ namespace math
     {
         if (x.real <= 0.0)
             throw std::runtime_error("x.real <= 0 at math::pow_x_x<_dual_number>");
-        auto xr_pow_xr = std::pow(x.real, x.real);
+        auto xr_pow_xr = pow(x.real, x.real);
         return calculus::details::_dual_number<var_type>{
             xr_pow_xr,
-            x.dual * xr_pow_xr * (1 + std::log(x.real))};
+            x.dual * xr_pow_xr * (1 + log(x.real))};
     }
 
     // pow f(x)^g(x)
-    // template <typename var_type>
-    // calculus::details::_dual_number<var_type> pow(calculus::details::_dual_number<var_type> x, calculus::details::_dual_number<var_type>g_x)
-    // {
-    //     auto xr_pow_xr = std::pow(x.real, x.real);
-    //     return calculus::details::_dual_number<var_type>{
-    //         xr_pow_xr,
-    //         x.dual * xr_pow_xr * (1 + std::log(x.real))};
-    // }
+    // the log(f) term only enters when g carries a tangent, so negative bases work for constant integral g
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> pow(calculus::details::_dual_number<var_type> f, calculus::details::_dual_number<var_type> g)
+    {
+        auto pow_fg = pow(f.real, g.real);
+        var_type dual{};
+        if (f.dual != 0.0)
+            dual = f.real != 0.0
+                       ? f.dual * g.real * pow_fg / f.real
+                       : f.dual * g.real * pow(f.real, g.real - 1.0);
+        if (g.dual != 0.0)
+        {
+            if (f.real < 0.0)
+                throw std::runtime_error("f.real < 0 at math::pow_f_g<_dual_number>");
+            if (f.real > 0.0)
+                dual += g.dual * pow_fg * log(f.real);
+        }
+        return calculus::details::_dual_number<var_type>{pow_fg, dual};
+    }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> exp(calculus::details::_dual_number<var_type> x)
     {
-        auto exp_xr = std::exp(x.real);
+        auto exp_xr = exp(x.real);
         return calculus::details::_dual_number<var_type>{
             exp_xr,
             x.dual * exp_xr};
@@ -293,10 +712,10 @@ namespace math
     {
         if (x.real <= 0.0)
             throw std::runtime_error("x.real <= 0 at math::exp_n_x<_dual_number>");
-        auto exp_n_xr = std::pow(n, x.real);
+        auto exp_n_xr = pow(n, x.real);
         return calculus::details::_dual_number<var_type>{
             exp_n_xr,
-            x.dual * std::log(n) * exp_n_xr};
+            x.dual * log(n) * exp_n_xr};
     }
 
     template <typename var_type>
@@ -305,7 +724,7 @@ namespace math
         if (x.real <= 0.0)
             throw std::runtime_error("x.real <= 0 at math::ln<_dual_number>");
         return calculus::details::_dual_number<var_type>{
-            std::log(x.real),
+            log(x.real),
             x.dual / x.real};
     }
 
@@ -323,9 +742,9 @@ namespace math
             throw std::runtime_error("n <= 0 || n = 1 at math::log_n_x<_dual_number>");
         if (x.real <= 0.0)
             throw std::runtime_error("x.real <= 0 at math::log_n_x<_dual_number>");
-        auto ln_n = std::log(n);
+        auto ln_n = log(n);
         return calculus::details::_dual_number<var_type>{
-            std::log(x.real) / ln_n,
+            log(x.real) / ln_n,
             x.dual / (x.real * ln_n)};
     }
 
@@ -337,8 +756,8 @@ namespace math
             throw std::runtime_error("n <= 0 at math::log_x_n<_dual_number>");
         if (x.real <= 0.0 || x.real == 1.0)
             throw std::runtime_error("x.real <= 0 || x.real = 1 at math::log_x_n<_dual_number>");
-        auto ln_n = std::log(n);
-        auto ln_x = std::log(x.real);
+        auto ln_n = log(n);
+        auto ln_x = log(x.real);
         return calculus::details::_dual_number<var_type>{
             ln_n / ln_x,
             x.dual * (-ln_n / (x.real * ln_x * ln_x))};
@@ -350,24 +769,24 @@ namespace math
     calculus::details::_dual_number<var_type> sin(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::sin(x.real),
-            x.dual * (std::cos(x.real))};
+            sin(x.real),
+            x.dual * (cos(x.real))};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> cos(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::cos(x.real),
-            x.dual * (-std::sin(x.real))};
+            cos(x.real),
+            x.dual * (-sin(x.real))};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> tan(calculus::details::_dual_number<var_type> x)
     {
-        // if (std::cos(x.real) == 0.0)
+        // if (cos(x.real) == 0.0)
         //     throw std::runtime_error("x.real == k(pi / 2) at math::tan<_dual_number>");
-        auto tan_xr = std::tan(x.real);
+        auto tan_xr = tan(x.real);
         return calculus::details::_dual_number<var_type>{
             tan_xr,
             x.dual * (1.0 + tan_xr * tan_xr)};
@@ -376,7 +795,7 @@ namespace math
     template <typename var_type>
     calculus::details::_dual_number<var_type> cot(calculus::details::_dual_number<var_type> x)
     {
-        auto cot_xr = 1.0 / std::tan(x.real);
+        auto cot_xr = 1.0 / tan(x.real);
         return calculus::details::_dual_number<var_type>{
             cot_xr,
             x.dual * (-1.0 - cot_xr * cot_xr)};
@@ -385,42 +804,42 @@ namespace math
     template <typename var_type>
     calculus::details::_dual_number<var_type> sec(calculus::details::_dual_number<var_type> x)
     {
-        auto cos_xr = std::cos(x.real);
+        auto cos_xr = cos(x.real);
         return calculus::details::_dual_number<var_type>{
             1.0 / cos_xr,
-            x.dual * (std::tan(x.real) / cos_xr)};
+            x.dual * (tan(x.real) / cos_xr)};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> csc(calculus::details::_dual_number<var_type> x)
     {
-        auto sin_xr = std::sin(x.real);
+        auto sin_xr = sin(x.real);
         return calculus::details::_dual_number<var_type>{
             1.0 / sin_xr,
-            x.dual * (-1.0 / (sin_xr * std::tan(x.real)))};
+            x.dual * (-1.0 / (sin_xr * tan(x.real)))};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> asin(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::asin(x.real),
-            x.dual / (std::sqrt(1 - x.real * x.real))};
+            asin(x.real),
+            x.dual / (sqrt(1 - x.real * x.real))};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> acos(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::acos(x.real),
-            -x.dual / (std::sqrt(1.0 - x.real * x.real))};
+            acos(x.real),
+            -x.dual / (sqrt(1.0 - x.real * x.real))};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> atan(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::atan(x.real),
+            atan(x.real),
             x.dual / (1.0 + x.real * x.real)};
     }
 
@@ -428,7 +847,7 @@ namespace math
     calculus::details::_dual_number<var_type> acot(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::atan(1.0 / x.real),
+            atan(1.0 / x.real),
             x.dual / (-1.0 - x.real * x.real)};
     }
 
@@ -436,16 +855,28 @@ namespace math
     calculus::details::_dual_number<var_type> asec(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::acos(1.0 / x.real),
-            x.dual / (std::abs(x.real) * std::sqrt(x.real * x.real - 1))};
+            acos(1.0 / x.real),
+            x.dual / (abs(x.real) * sqrt(x.real * x.real - 1))};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> acsc(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::acos(1.0 / x.real),
-            -x.dual / (std::abs(x.real) * std::sqrt(x.real * x.real - 1))};
+            asin(1.0 / x.real),
+            -x.dual / (abs(x.real) * sqrt(x.real * x.real - 1))};
+    }
+
+    // angle of (x, y), x.real != 0 || y.real != 0
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> atan2(calculus::details::_dual_number<var_type> y, calculus::details::_dual_number<var_type> x)
+    {
+        auto r_sq = x.real * x.real + y.real * y.real;
+        if (r_sq == 0.0)
+            throw std::runtime_error("x.real = y.real = 0 at math::atan2<_dual_number>");
+        return calculus::details::_dual_number<var_type>{
+            atan2(y.real, x.real),
+            (x.real * y.dual - y.real * x.dual) / r_sq};
     }
 
     // hyperbolic group
@@ -454,22 +885,22 @@ namespace math
     calculus::details::_dual_number<var_type> sinh(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::sinh(x.real),
-            x.dual * std::cosh(x.real)};
+            sinh(x.real),
+            x.dual * cosh(x.real)};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> cosh(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::cosh(x.real),
-            x.dual * std::sinh(x.real)};
+            cosh(x.real),
+            x.dual * sinh(x.real)};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> tanh(calculus::details::_dual_number<var_type> x)
     {
-        auto tanh_xr = std::tanh(x.real);
+        auto tanh_xr = tanh(x.real);
         return calculus::details::_dual_number<var_type>{
             tanh_xr,
             x.dual * (1.0 - tanh_xr * tanh_xr)};
@@ -478,7 +909,7 @@ namespace math
     template <typename var_type>
     calculus::details::_dual_number<var_type> coth(calculus::details::_dual_number<var_type> x)
     {
-        auto coth_xr = 1.0 / std::tanh(x.real);
+        auto coth_xr = 1.0 / tanh(x.real);
         return calculus::details::_dual_number<var_type>{
             coth_xr,
             x.dual * (1.0 - coth_xr * coth_xr)};
@@ -487,71 +918,364 @@ namespace math
     template <typename var_type>
     calculus::details::_dual_number<var_type> sech(calculus::details::_dual_number<var_type> x)
     {
-        auto sech_xr = 1.0 / std::cosh(x.real);
+        auto sech_xr = 1.0 / cosh(x.real);
         return calculus::details::_dual_number<var_type>{
             sech_xr,
-            x.dual * (-sech_xr * std::tanh(x.real))};
+            x.dual * (-sech_xr * tanh(x.real))};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> csch(calculus::details::_dual_number<var_type> x)
     {
-        auto csch_xr = 1.0 / std::sinh(x.real);
+        auto csch_xr = 1.0 / sinh(x.real);
         return calculus::details::_dual_number<var_type>{
             csch_xr,
-            x.dual * (-csch_xr / std::tanh(x.real))};
+            x.dual * (-csch_xr / tanh(x.real))};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> asinh(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::asinh(x.real),
-            x.dual * std::sqrt(1.0 + x.real * x.real)};
+            asinh(x.real),
+            x.dual / sqrt(1.0 + x.real * x.real)};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> acosh(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::acosh(x.real),
-            x.dual * std::sqrt(x.real * x.real - 1.0)};
+            acosh(x.real),
+            x.dual / sqrt(x.real * x.real - 1.0)};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> atanh(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::atanh(x.real),
-            x.dual * (1.0 - x.real * x.real)};
+            atanh(x.real),
+            x.dual / (1.0 - x.real * x.real)};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> acoth(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::atanh(1.0 / x.real),
-            x.dual * (1.0 - x.real * x.real)};
+            atanh(1.0 / x.real),
+            x.dual / (1.0 - x.real * x.real)};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> asech(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::acosh(1.0 / x.real),
-            -x.dual * x.real * std::sqrt(1.0 - x.real * x.real)};
+            acosh(1.0 / x.real),
+            -x.dual / (x.real * sqrt(1.0 - x.real * x.real))};
     }
 
     template <typename var_type>
     calculus::details::_dual_number<var_type> acsch(calculus::details::_dual_number<var_type> x)
     {
         return calculus::details::_dual_number<var_type>{
-            std::acosh(1.0 / x.real),
-            -x.dual * std::abs(x.real) * std::sqrt(1.0 + x.real * x.real)};
+            asinh(1.0 / x.real),
+            -x.dual / (abs(x.real) * sqrt(1.0 + x.real * x.real))};
     }
 
     // miscellaneous group
 
+    // x * y + z with a single rounding of the value
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fma(calculus::details::_dual_number<var_type> x, calculus::details::_dual_number<var_type> y, calculus::details::_dual_number<var_type> z)
+    {
+        return calculus::details::_dual_number<var_type>{
+            fma(x.real, y.real, z.real),
+            x.dual * y.real + x.real * y.dual + z.dual};
+    }
+
+    // ties take the tangent of x, a NaN operand yields the other one as in std::fmin
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fmin(calculus::details::_dual_number<var_type> x, calculus::details::_dual_number<var_type> y)
+    {
+        return (y.real < x.real || isnan(x.real)) ? y : x;
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fmax(calculus::details::_dual_number<var_type> x, calculus::details::_dual_number<var_type> y)
+    {
+        return (y.real > x.real || isnan(x.real)) ? y : x;
+    }
+
+    // activation group, value and tangent share one exp and never overflow
+
+    // 1 / (1 + e^-x) through e = e^-|x| <= 1, the derivative e / (1 + e)^2 keeps its digits in both tails
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> sigmoid(calculus::details::_dual_number<var_type> x)
+    {
+        var_type e = exp(-abs(x.real));
+        var_type inv = 1.0 / (1.0 + e);
+        return calculus::details::_dual_number<var_type>{
+            (x.real >= 0.0 ? 1.0 : e) * inv,
+            x.dual * e * inv * inv};
+    }
+
+    // log(1 + e^x) = max(x, 0) + log1p(e^-|x|), its derivative is sigmoid(x)
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> softplus(calculus::details::_dual_number<var_type> x)
+    {
+        var_type e = exp(-abs(x.real));
+        var_type s = (x.real >= 0.0 ? 1.0 : e) / (1.0 + e);
+        return calculus::details::_dual_number<var_type>{
+            fmax(x.real, 0.0) + log1p(e),
+            x.dual * s};
+    }
+
+    // the subgradient at 0 is taken as 0
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> relu(calculus::details::_dual_number<var_type> x)
+    {
+        return x.real > 0.0 ? x : calculus::details::_dual_number<var_type>{0.0};
+    }
+
+    // x for x > 0, slope * x otherwise, so the subgradient at 0 is slope
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> leaky_relu(calculus::details::_dual_number<var_type> x, typename calculus::details::_dual_number<var_type>::type slope)
+    {
+        return x.real > 0.0 ? x : calculus::details::_dual_number<var_type>{slope * x.real, slope * x.dual};
+    }
+
+    // log(sum e^x[i]) shifted by the largest x[i], the tangent is the softmax weighted sum of the x[i] tangents;
+    // an infinite largest x[i] is the value, count = 0 gives -inf
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> logsumexp(const calculus::details::_dual_number<var_type> *x, size_type count)
+    {
+        var_type shift = -std::numeric_limits<var_type>::infinity();
+        for (size_type i = 0; i < count; ++i)
+            shift = fmax(shift, x[i].real);
+        if (count == 0)
+            return calculus::details::_dual_number<var_type>{shift};
+
+        var_type sum = 0.0, tangent = 0.0;
+        for (size_type i = 0; i < count; ++i)
+        {
+            var_type e = calculus::details::_shifted_exp(x[i].real, shift);
+            sum += e;
+            tangent += e * x[i].dual;
+        }
+        return calculus::details::_dual_number<var_type>{isinf(shift) ? shift : shift + log(sum), tangent / sum};
+    }
+
+    // result[i] = e^x[i] / sum e^x[j], result[i]' = result[i] * (x[i]' - sum result[j] * x[j]'),
+    // infinite x[i] are taken in the limit, result may alias x
+    template <typename var_type>
+    void softmax(const calculus::details::_dual_number<var_type> *x, calculus::details::_dual_number<var_type> *result, size_type count)
+    {
+        var_type shift = -std::numeric_limits<var_type>::infinity();
+        for (size_type i = 0; i < count; ++i)
+            shift = fmax(shift, x[i].real);
+
+        var_type sum = 0.0, tangent = 0.0;
+        for (size_type i = 0; i < count; ++i)
+        {
+            var_type e = calculus::details::_shifted_exp(x[i].real, shift);
+            sum += e;
+            tangent += e * x[i].dual;
+            result[i].real = e;
+        }
+        var_type inv = 1.0 / sum;
+        tangent *= inv;
+        for (size_type i = 0; i < count; ++i)
+        {
+            result[i].real *= inv;
+            result[i].dual = result[i].real * (x[i].dual - tangent);
+        }
+    }
+
+    // polynomial group, the tangent is p'(x) x' with p' summed next to p, no dual arithmetic per term
+
+    // x^n and n x^(n - 1) from the same squarings, x.real = 0 is fine for n > 0
+    template <int n, typename var_type>
+    calculus::details::_dual_number<var_type> ipow(calculus::details::_dual_number<var_type> x)
+    {
+        static_assert(n != 0, "ipow<0> is the constant 1");
+        var_type below = calculus::details::_natural_power<(n > 0 ? n - 1 : -n - 1)>::apply(x.real);
+        if (n > 0)
+            return calculus::details::_dual_number<var_type>{below * x.real, n * below * x.dual};
+        var_type inv = 1.0 / (below * x.real);
+        return calculus::details::_dual_number<var_type>{inv, n * below * inv * inv * x.dual};
+    }
+
+    // sum coefficients[k] * x^k for k < count
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> polyval(const var_type *coefficients, size_type count, calculus::details::_dual_number<var_type> x)
+    {
+        var_type p, dp;
+        calculus::details::_polynomial_and_derivative(coefficients, count, x.real, p, dp);
+        return calculus::details::_dual_number<var_type>{p, dp * x.dual};
+    }
+
+    // p(x) / q(x) with one division for the value and the tangent
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> ratval(const var_type *numerator, size_type numerator_count,
+                                                     const var_type *denominator, size_type denominator_count,
+                                                     calculus::details::_dual_number<var_type> x)
+    {
+        var_type p, dp, q, dq;
+        calculus::details::_polynomial_and_derivative(numerator, numerator_count, x.real, p, dp);
+        calculus::details::_polynomial_and_derivative(denominator, denominator_count, x.real, q, dq);
+        var_type inv = 1.0 / q;
+        return calculus::details::_dual_number<var_type>{p * inv, (dp - p * inv * dq) * inv * x.dual};
+    }
+
+    // mixed group, a plain argument is a constant and costs no tangent arithmetic
+
+    // b^x, b >= 0 unless x carries no tangent
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> pow(typename calculus::details::_dual_number<var_type>::type b, calculus::details::_dual_number<var_type> x)
+    {
+        auto pow_bx = pow(b, x.real);
+        var_type dual{};
+        if (x.dual != 0.0)
+        {
+            if (b < 0.0)
+                throw std::runtime_error("b < 0 at math::pow_b_x<_dual_number>");
+            if (b > 0.0)
+                dual = x.dual * pow_bx * log(b);
+        }
+        return calculus::details::_dual_number<var_type>{pow_bx, dual};
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> hypot(calculus::details::_dual_number<var_type> x, typename calculus::details::_dual_number<var_type>::type y)
+    {
+        auto hypot_xy = hypot(x.real, y);
+        if (hypot_xy == 0.0)
+            throw std::runtime_error("x = y = 0 at math::hypot<_dual_number>");
+        return calculus::details::_dual_number<var_type>{
+            hypot_xy,
+            x.dual * x.real / hypot_xy};
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> hypot(typename calculus::details::_dual_number<var_type>::type x, calculus::details::_dual_number<var_type> y)
+    {
+        auto hypot_xy = hypot(x, y.real);
+        if (hypot_xy == 0.0)
+            throw std::runtime_error("x = y = 0 at math::hypot<_dual_number>");
+        return calculus::details::_dual_number<var_type>{
+            hypot_xy,
+            y.dual * y.real / hypot_xy};
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> atan2(calculus::details::_dual_number<var_type> y, typename calculus::details::_dual_number<var_type>::type x)
+    {
+        auto r_sq = x * x + y.real * y.real;
+        if (r_sq == 0.0)
+            throw std::runtime_error("x = y = 0 at math::atan2<_dual_number>");
+        return calculus::details::_dual_number<var_type>{
+            atan2(y.real, x),
+            x * y.dual / r_sq};
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> atan2(typename calculus::details::_dual_number<var_type>::type y, calculus::details::_dual_number<var_type> x)
+    {
+        auto r_sq = x.real * x.real + y * y;
+        if (r_sq == 0.0)
+            throw std::runtime_error("x = y = 0 at math::atan2<_dual_number>");
+        return calculus::details::_dual_number<var_type>{
+            atan2(y, x.real),
+            -y * x.dual / r_sq};
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fma(calculus::details::_dual_number<var_type> x, calculus::details::_dual_number<var_type> y, typename calculus::details::_dual_number<var_type>::type z)
+    {
+        return calculus::details::_dual_number<var_type>{
+            fma(x.real, y.real, z),
+            x.dual * y.real + x.real * y.dual};
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fma(calculus::details::_dual_number<var_type> x, typename calculus::details::_dual_number<var_type>::type y, calculus::details::_dual_number<var_type> z)
+    {
+        return calculus::details::_dual_number<var_type>{
+            fma(x.real, y, z.real),
+            x.dual * y + z.dual};
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fma(typename calculus::details::_dual_number<var_type>::type x, calculus::details::_dual_number<var_type> y, calculus::details::_dual_number<var_type> z)
+    {
+        return calculus::details::_dual_number<var_type>{
+            fma(x, y.real, z.real),
+            x * y.dual + z.dual};
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fma(calculus::details::_dual_number<var_type> x, typename calculus::details::_dual_number<var_type>::type y, typename calculus::details::_dual_number<var_type>::type z)
+    {
+        return calculus::details::_dual_number<var_type>{
+            fma(x.real, y, z),
+            x.dual * y};
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fma(typename calculus::details::_dual_number<var_type>::type x, calculus::details::_dual_number<var_type> y, typename calculus::details::_dual_number<var_type>::type z)
+    {
+        return calculus::details::_dual_number<var_type>{
+            fma(x, y.real, z),
+            x * y.dual};
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fma(typename calculus::details::_dual_number<var_type>::type x, typename calculus::details::_dual_number<var_type>::type y, calculus::details::_dual_number<var_type> z)
+    {
+        return calculus::details::_dual_number<var_type>{
+            fma(x, y, z.real),
+            z.dual};
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fmin(calculus::details::_dual_number<var_type> x, typename calculus::details::_dual_number<var_type>::type y)
+    {
+        return (y < x.real || isnan(x.real)) ? calculus::details::_dual_number<var_type>{y} : x;
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fmin(typename calculus::details::_dual_number<var_type>::type x, calculus::details::_dual_number<var_type> y)
+    {
+        return (y.real < x || isnan(x)) ? y : calculus::details::_dual_number<var_type>{x};
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fmax(calculus::details::_dual_number<var_type> x, typename calculus::details::_dual_number<var_type>::type y)
+    {
+        return (y > x.real || isnan(x.real)) ? calculus::details::_dual_number<var_type>{y} : x;
+    }
+
+    template <typename var_type>
+    calculus::details::_dual_number<var_type> fmax(typename calculus::details::_dual_number<var_type>::type x, calculus::details::_dual_number<var_type> y)
+    {
+        return (y.real > x || isnan(x)) ? y : calculus::details::_dual_number<var_type>{x};
+    }
+
+    // y += a * x in place, y may alias x
+    template <typename var_type>
+    void axpy(var_type a, const calculus::details::_dual_number<var_type> &x, calculus::details::_dual_number<var_type> &y) noexcept
+    {
+        y.real += a * x.real;
+        y.dual += a * x.dual;
+    }
+
+    // the tangent is accumulated first so that y may alias a or x
+    template <typename var_type>
+    void axpy(const calculus::details::_dual_number<var_type> &a, const calculus::details::_dual_number<var_type> &x, calculus::details::_dual_number<var_type> &y) noexcept
+    {
+        y.dual += a.real * x.dual + a.dual * x.real;
+        y.real += a.real * x.real;
+    }
+
 #else // !defined USE_GLOBAL_FLOATING_POINT_TYPE
     // x.real != 0
     calculus::details::_dual_number abs(calculus::details::_dual_number x);
@@ -566,7 +1290,10 @@ namespace math
 
     calculus::details::_dual_number cbrt(calculus::details::_dual_number x);
 
-    // x^x or f(x) ^ f(x)
+    // x.real != 0 || y.real != 0
+    calculus::details::_dual_number hypot(calculus::details::_dual_number x, calculus::details::_dual_number y);
+
+    // x^p, x.real = 0 is fine for p >= 1
     calculus::details::_dual_number pow(calculus::details::_dual_number x, math::real p);
 
     // exponential and logarithmic group
@@ -574,7 +1301,7 @@ namespace math
     calculus::details::_dual_number pow(calculus::details::_dual_number x);
 
     // pow f(x)^g(x)
-    // calculus::details::_dual_number pow(calculus::details::_dual_number x, algebra::dual_numberg_x)
+    calculus::details::_dual_number pow(calculus::details::_dual_number f, calculus::details::_dual_number g);
 
     calculus::details::_dual_number exp(calculus::details::_dual_number x);
 
@@ -616,6 +1343,9 @@ namespace math
 
     calculus::details::_dual_number acsc(calculus::details::_dual_number x);
 
+    // angle of (x, y), x.real != 0 || y.real != 0
+    calculus::details::_dual_number atan2(calculus::details::_dual_number y, calculus::details::_dual_number x);
+
     // hyperbolic group
 
     calculus::details::_dual_number sinh(calculus::details::_dual_number x);
@@ -644,6 +1374,172 @@ namespace math
 
     // miscellaneous group
 
+    calculus::details::_dual_number fma(calculus::details::_dual_number x, calculus::details::_dual_number y, calculus::details::_dual_number z);
+
+    calculus::details::_dual_number fmin(calculus::details::_dual_number x, calculus::details::_dual_number y);
+
+    calculus::details::_dual_number fmax(calculus::details::_dual_number x, calculus::details::_dual_number y);
+
+    // activation group, value and tangent share one exp and never overflow
+
+    calculus::details::_dual_number sigmoid(calculus::details::_dual_number x);
+
+    calculus::details::_dual_number softplus(calculus::details::_dual_number x);
+
+    // the subgradient at 0 is taken as 0
+    calculus::details::_dual_number relu(calculus::details::_dual_number x);
+
+    // the subgradient at 0 is slope
+    calculus::details::_dual_number leaky_relu(calculus::details::_dual_number x, math::real slope);
+
+    // an infinite largest x[i] is the value, count = 0 gives -inf
+    calculus::details::_dual_number logsumexp(const calculus::details::_dual_number *x, size_type count);
+
+    // infinite x[i] are taken in the limit, result may alias x
+    void softmax(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    // polynomial group, the tangent is p'(x) x' with p' summed next to p, no dual arithmetic per term
+
+    // x^n and n x^(n - 1) from the same squarings, x.real = 0 is fine for n > 0
+    template <int n>
+    calculus::details::_dual_number ipow(calculus::details::_dual_number x)
+    {
+        static_assert(n != 0, "ipow<0> is the constant 1");
+        math::real below = calculus::details::_natural_power<(n > 0 ? n - 1 : -n - 1)>::apply(x.real);
+        if (n > 0)
+            return calculus::details::_dual_number{below * x.real, n * below * x.dual};
+        math::real inv = 1.0 / (below * x.real);
+        return calculus::details::_dual_number{inv, n * below * inv * inv * x.dual};
+    }
+
+    calculus::details::_dual_number polyval(const math::real *coefficients, size_type count, calculus::details::_dual_number x);
+
+    calculus::details::_dual_number ratval(const math::real *numerator, size_type numerator_count,
+                                           const math::real *denominator, size_type denominator_count,
+                                           calculus::details::_dual_number x);
+
+    // mixed group, a plain argument is a constant and costs no tangent arithmetic
+
+    // b^x, b >= 0 unless x carries no tangent
+    calculus::details::_dual_number pow(math::real b, calculus::details::_dual_number x);
+
+    calculus::details::_dual_number hypot(calculus::details::_dual_number x, math::real y);
+
+    calculus::details::_dual_number hypot(math::real x, calculus::details::_dual_number y);
+
+    calculus::details::_dual_number atan2(calculus::details::_dual_number y, math::real x);
+
+    calculus::details::_dual_number atan2(math::real y, calculus::details::_dual_number x);
+
+    calculus::details::_dual_number fma(calculus::details::_dual_number x, calculus::details::_dual_number y, math::real z);
+
+    calculus::details::_dual_number fma(calculus::details::_dual_number x, math::real y, calculus::details::_dual_number z);
+
+    calculus::details::_dual_number fma(math::real x, calculus::details::_dual_number y, calculus::details::_dual_number z);
+
+    calculus::details::_dual_number fma(calculus::details::_dual_number x, math::real y, math::real z);
+
+    calculus::details::_dual_number fma(math::real x, calculus::details::_dual_number y, math::real z);
+
+    calculus::details::_dual_number fma(math::real x, math::real y, calculus::details::_dual_number z);
+
+    calculus::details::_dual_number fmin(calculus::details::_dual_number x, math::real y);
+
+    calculus::details::_dual_number fmin(math::real x, calculus::details::_dual_number y);
+
+    calculus::details::_dual_number fmax(calculus::details::_dual_number x, math::real y);
+
+    calculus::details::_dual_number fmax(math::real x, calculus::details::_dual_number y);
+
+    // y += a * x in place
+    void axpy(math::real a, const calculus::details::_dual_number &x, calculus::details::_dual_number &y) noexcept;
+
+    void axpy(const calculus::details::_dual_number &a, const calculus::details::_dual_number &x, calculus::details::_dual_number &y) noexcept;
+
+    // array-wide kernels, result[i] = function(x[i]) for i < count; abs, sq, cb, sqrt, relu and leaky_relu
+    // are vectorized with one clone per instruction set, picked at load time on x86-64 ELF targets,
+    // the others call libm once per element
+
+    void abs(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void sq(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void cb(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void sqrt(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void cbrt(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void exp(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void log(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void ln(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void sin(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void cos(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void tan(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void cot(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void sec(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void csc(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void asin(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void acos(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void atan(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void acot(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void asec(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void acsc(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void sinh(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void cosh(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void tanh(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void coth(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void sech(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void csch(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void asinh(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void acosh(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void atanh(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void acoth(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void asech(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void acsch(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void pow(const calculus::details::_dual_number *x, math::real p, calculus::details::_dual_number *result, size_type count);
+
+    void exp_n(math::real n, const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void log_n(math::real n, const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void log_x_n(const calculus::details::_dual_number *x, math::real n, calculus::details::_dual_number *result, size_type count);
+
+    void sigmoid(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void softplus(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void relu(const calculus::details::_dual_number *x, calculus::details::_dual_number *result, size_type count);
+
+    void leaky_relu(const calculus::details::_dual_number *x, math::real slope, calculus::details::_dual_number *result, size_type count);
+
 #endif // !defined USE_GLOBAL_FLOATING_POINT_TYPE
 } // namespace math
 
@@ -39,6 +39,52 @@ namespace math::calculus
             return (f(_dual_number<var_tp>{x, 1.0}) - f(_dual_number<var_tp>{x}).real).dual;
         }
 #endif // USE_GLOBAL_FLOATING_POINT_TYPE
+
+        // integral arguments are promoted like in the single variable version
+        template <typename var_tp>
+        using _plain_t = std::conditional_t<std::is_integral<var_tp>::value, math::real, var_tp>;
+
+        template <std::size_t pos, std::size_t index, typename var_tp>
+        auto _activate(var_tp x, std::enable_if_t<index == pos> * = nullptr)
+        {
+#ifdef USE_GLOBAL_FLOATING_POINT_TYPE
+            return _dual_number{static_cast<math::real>(x), 1.0};
+#else
+            return _dual_number<_plain_t<var_tp>>{static_cast<_plain_t<var_tp>>(x), 1.0};
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+        }
+
+        template <std::size_t pos, std::size_t index, typename var_tp>
+        auto _activate(var_tp x, std::enable_if_t<index != pos> * = nullptr)
+        {
+            return static_cast<_plain_t<var_tp>>(x);
+        }
+
+        template <std::size_t pos, typename func_tp, std::size_t... index, typename... var_tp>
+        auto _evaluate_active(func_tp &f, std::index_sequence<index...>, var_tp... vars)
+        {
+            return f(_activate<pos, index>(vars)...);
+        }
+
+#ifdef USE_GLOBAL_FLOATING_POINT_TYPE
+        inline math::real _tangent(_dual_number y) noexcept
+        {
+            return y.dual;
+        }
+#else
+        template <typename value_type>
+        value_type _tangent(const _dual_number<value_type> &y) noexcept
+        {
+            return y.dual;
+        }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+
+        // f does not depend on the active argument
+        template <typename value_type, typename = std::enable_if_t<std::is_arithmetic<value_type>::value>>
+        value_type _tangent(value_type) noexcept
+        {
+            return value_type{};
+        }
     }  // namespace math::calculus::details
 #ifdef USE_GLOBAL_FLOATING_POINT_TYPE
       // calculate differentiation of single variable functions
@@ -59,35 +105,14 @@ namespace math::calculus
                 var_tp>>(f, x);
     }
 #endif // USE_GLOBAL_FLOATING_POINT_TYPE
-#if __cplusplus >= 201703L
-    template <int pos, typename func_tp, typename... var_tp>
-    auto first_order_derivative(func_tp f, var_tp... vars)
-    {
-        auto var_tuple = std::make_tuple(_dual_number{vars}...);
-        std::get<pos>(var_tuple).dual = 1.0f;
-        return (std::apply(f, var_tuple) - std::apply(f, var_tuple).real).dual;
-    }
-#else // C++14
-#ifdef USE_GLOBAL_FLOATING_POINT_TYPE
-    template <int pos, typename func_tp, typename... var_type>
-    auto first_order_derivative(func_tp f, var_type... vars)
-    {
-        auto var_tuple = std::make_tuple(_dual_number{vars}...);
-        std::get<pos>(var_tuple).dual = 1.0f;
-        auto temp = details::_pass_tuple_as_function_arguments(f, var_tuple);
-        return (temp - temp.real).dual;
-    }
-#else  // !defined USE_GLOBAL_FLOATING_POINT_TYPE
+    // only the argument at pos is active, every other one is passed to f as a plain value,
+    // so f is evaluated once and does no tangent arithmetic on its constant parameters
     template <int pos, typename func_tp, typename... var_tp>
     auto first_order_derivative(func_tp f, var_tp... vars)
     {
-        auto var_tuple = std::make_tuple(details::_dual_number<decltype(vars)>{vars}...);
-        std::get<pos>(var_tuple).dual = 1.0f;
-        auto temp = details::_pass_tuple_as_function_arguments(f, var_tuple);
-        return (temp - temp.real).dual;
+        static_assert(pos >= 0 && pos < static_cast<int>(sizeof...(var_tp)), "pos is not an argument index");
+        return details::_tangent(details::_evaluate_active<pos>(f, std::index_sequence_for<var_tp...>{}, vars...));
     }
-#endif // USE_GLOBAL_FLOATING_POINT_TYPE
-#endif // c++17
 
 } // namespace math::calculus
 
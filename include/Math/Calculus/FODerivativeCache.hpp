@@ -0,0 +1,268 @@
+#ifndef MATH_CALCULUS_FO_DERIVATIVE_CACHE_HPP
+#define MATH_CALCULUS_FO_DERIVATIVE_CACHE_HPP
+
+#include "Config.hpp"
+
+#include "FOAutoDiff.hpp"
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace details
+    {
+        // order 0 fills value only, order 1 fills value and gradient
+        template <typename value_type, size_type var_count>
+        struct _derivative_record
+        {
+            value_type value;
+            std::array<value_type, var_count> gradient;
+        };
+
+        // bits[i] is a multiple of the tolerance, or the bit pattern of x[i] where exact[i] is set,
+        // so the two encodings never compare equal
+        template <size_type var_count>
+        struct _cache_key
+        {
+            std::array<std::int64_t, var_count> bits;
+            std::array<bool, var_count> exact;
+            size_type order;
+
+            bool operator==(const _cache_key &rhs) const noexcept
+            {
+                return order == rhs.order && bits == rhs.bits && exact == rhs.exact;
+            }
+        };
+
+        template <size_type var_count>
+        struct _cache_key_hash
+        {
+            std::size_t operator()(const _cache_key<var_count> &key) const noexcept
+            {
+                std::uint64_t h = 0x9e3779b97f4a7c15ull ^ key.order;
+                for (size_type i = 0; i < var_count; ++i)
+                {
+                    h ^= static_cast<std::uint64_t>(key.bits[i]) + key.exact[i];
+                    h *= 0xff51afd7ed558ccdull;
+                    h ^= h >> 33;
+                }
+                return static_cast<std::size_t>(h);
+            }
+        };
+
+        template <typename func_tp, typename array_type, std::size_t... index>
+        auto _apply_array(func_tp &f, array_type &args, std::index_sequence<index...>)
+        {
+            return f(args[index]...);
+        }
+
+        template <typename func_tp, typename value_type, size_type var_count>
+        class _memoized_derivative
+        {
+            static_assert(std::is_floating_point<value_type>::value);
+            typedef _derivative_record<value_type, var_count> record_type;
+            typedef _cache_key<var_count> key_type;
+
+            // one lock per shard, a CLOCK hand sweeps the slots of a full shard
+            struct _shard
+            {
+                struct _slot
+                {
+                    key_type key;
+                    record_type record;
+                    bool referenced;
+                };
+
+                std::mutex mutex;
+                std::unordered_map<key_type, size_type, _cache_key_hash<var_count>> index;
+                std::vector<_slot> slots;
+                size_type hand = 0;
+                std::atomic<std::uint64_t> hits{0};
+                std::atomic<std::uint64_t> misses{0};
+            };
+
+        public:
+            static constexpr size_type shard_count = 16;
+
+            // tolerance = 0 keys on the exact bit pattern of the inputs, otherwise inputs are quantized to
+            // multiples of tolerance; an input too large to quantize into 64 bits, inf or NaN keys on its bits
+            _memoized_derivative(func_tp f, std::size_t byte_budget, value_type tolerance = value_type{})
+                : _function(std::move(f)), _tolerance{tolerance}, _shards(new _shard[shard_count])
+            {
+                if (tolerance < 0.0)
+                    throw std::runtime_error("tolerance < 0 at math::calculus::memoize");
+                std::size_t slot_bytes = sizeof(typename _shard::_slot) + 2 * sizeof(void *) + sizeof(key_type);
+                _shard_capacity = static_cast<size_type>(byte_budget / (slot_bytes * shard_count));
+                if (_shard_capacity == 0)
+                    _shard_capacity = 1;
+                for (size_type s = 0; s < shard_count; ++s)
+                {
+                    _shards[s].slots.reserve(_shard_capacity);
+                    _shards[s].index.reserve(_shard_capacity);
+                }
+            }
+
+            // f(x...) alone for order 0, together with its gradient for order 1
+            template <typename... var_tp>
+            record_type evaluate(size_type order, var_tp... vars)
+            {
+                static_assert(sizeof...(var_tp) == var_count);
+                if (order > 1)
+                    throw std::runtime_error("order > 1 at math::calculus::_memoized_derivative");
+
+                std::array<value_type, var_count> x{static_cast<value_type>(vars)...};
+                key_type key = _make_key(x, order);
+                std::size_t hash = _cache_key_hash<var_count>{}(key);
+                _shard &shard = _shards[(hash >> 7) % shard_count];
+
+                {
+                    std::lock_guard<std::mutex> lock{shard.mutex};
+                    auto it = shard.index.find(key);
+                    if (it != shard.index.end())
+                    {
+                        shard.slots[it->second].referenced = true;
+                        shard.hits.fetch_add(1, std::memory_order_relaxed);
+                        return shard.slots[it->second].record;
+                    }
+                    shard.misses.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                // computed outside the lock, a concurrent miss on the same key just stores it twice
+                record_type record = _compute(x, order);
+                std::lock_guard<std::mutex> lock{shard.mutex};
+                if (shard.index.find(key) == shard.index.end())
+                    _insert(shard, key, record);
+                return record;
+            }
+
+            std::uint64_t hits() const noexcept
+            {
+                std::uint64_t total = 0;
+                for (size_type s = 0; s < shard_count; ++s)
+                    total += _shards[s].hits.load(std::memory_order_relaxed);
+                return total;
+            }
+
+            std::uint64_t misses() const noexcept
+            {
+                std::uint64_t total = 0;
+                for (size_type s = 0; s < shard_count; ++s)
+                    total += _shards[s].misses.load(std::memory_order_relaxed);
+                return total;
+            }
+
+            std::size_t size()
+            {
+                std::size_t total = 0;
+                for (size_type s = 0; s < shard_count; ++s)
+                {
+                    std::lock_guard<std::mutex> lock{_shards[s].mutex};
+                    total += _shards[s].slots.size();
+                }
+                return total;
+            }
+
+            void clear()
+            {
+                for (size_type s = 0; s < shard_count; ++s)
+                {
+                    std::lock_guard<std::mutex> lock{_shards[s].mutex};
+                    _shards[s].index.clear();
+                    _shards[s].slots.clear();
+                    _shards[s].hand = 0;
+                    _shards[s].hits.store(0, std::memory_order_relaxed);
+                    _shards[s].misses.store(0, std::memory_order_relaxed);
+                }
+            }
+
+        private:
+            key_type _make_key(const std::array<value_type, var_count> &x, size_type order) const noexcept
+            {
+                key_type key{};
+                key.order = order;
+                for (size_type i = 0; i < var_count; ++i)
+                {
+                    value_type quantized = _tolerance > 0.0 ? x[i] / _tolerance : value_type{};
+                    if (_tolerance > 0.0 && std::fabs(quantized) < 9.2e18)
+                        key.bits[i] = static_cast<std::int64_t>(std::llround(quantized));
+                    else
+                    {
+                        std::memcpy(&key.bits[i], &x[i], sizeof(value_type));
+                        key.exact[i] = _tolerance > 0.0;
+                    }
+                }
+                return key;
+            }
+
+            record_type _compute(const std::array<value_type, var_count> &x, size_type order)
+            {
+                record_type record{};
+                std::array<_dual_number<value_type>, var_count> dx;
+                for (size_type i = 0; i < var_count; ++i)
+                    dx[i] = _dual_number<value_type>{x[i]};
+
+                if (order == 0)
+                {
+                    record.value = _apply_array(_function, dx, std::make_index_sequence<var_count>{}).real;
+                    return record;
+                }
+                for (size_type pos = 0; pos < var_count; ++pos)
+                {
+                    dx[pos].dual = 1.0;
+                    auto result = _apply_array(_function, dx, std::make_index_sequence<var_count>{});
+                    dx[pos].dual = 0.0;
+                    record.value = result.real;
+                    record.gradient[pos] = result.dual;
+                }
+                return record;
+            }
+
+            void _insert(_shard &shard, const key_type &key, const record_type &record)
+            {
+                if (shard.slots.size() < _shard_capacity)
+                {
+                    shard.index.emplace(key, static_cast<size_type>(shard.slots.size()));
+                    shard.slots.push_back({key, record, false});
+                    return;
+                }
+                while (shard.slots[shard.hand].referenced)
+                {
+                    shard.slots[shard.hand].referenced = false;
+                    shard.hand = (shard.hand + 1) % _shard_capacity;
+                }
+                auto &victim = shard.slots[shard.hand];
+                shard.index.erase(victim.key);
+                victim = {key, record, false};
+                shard.index.emplace(key, shard.hand);
+                shard.hand = (shard.hand + 1) % _shard_capacity;
+            }
+
+            func_tp _function;
+            value_type _tolerance;
+            size_type _shard_capacity;
+            std::unique_ptr<_shard[]> _shards;
+        };
+    } // namespace math::calculus::details
+
+    // opt-in memoization of f and its gradient, keeps at most about byte_budget bytes of entries
+    template <size_type var_count, typename value_type = math::real, typename func_tp>
+    auto memoize(func_tp f, std::size_t byte_budget, value_type tolerance = value_type{})
+    {
+        return details::_memoized_derivative<func_tp, value_type, var_count>{std::move(f), byte_budget, tolerance};
+    }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_FO_DERIVATIVE_CACHE_HPP
\ No newline at end of file
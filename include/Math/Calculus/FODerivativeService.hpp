@@ -0,0 +1,338 @@
+#ifndef MATH_CALCULUS_FO_DERIVATIVE_SERVICE_HPP
+#define MATH_CALCULUS_FO_DERIVATIVE_SERVICE_HPP
+
+#include "Config.hpp"
+
+#include "FOAutoDiff.hpp"
+#include "Utility/Parallel.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace details
+    {
+        // bounded multi-producer multi-consumer ring, each cell carries a sequence number
+        // telling producers and consumers whose turn it is, capacity is a power of two
+        template <typename element_type>
+        class _mpmc_queue
+        {
+            struct _cell
+            {
+                std::atomic<std::size_t> sequence;
+                element_type data;
+            };
+
+        public:
+            explicit _mpmc_queue(std::size_t capacity)
+            {
+                std::size_t size = 2;
+                while (size < capacity)
+                    size *= 2;
+                _mask = size - 1;
+                _cells.reset(new _cell[size]);
+                for (std::size_t i = 0; i < size; ++i)
+                    _cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            bool try_push(element_type &element)
+            {
+                std::size_t position = _tail.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    _cell &cell = _cells[position & _mask];
+                    std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                    auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+                    if (difference == 0)
+                    {
+                        if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            cell.data = std::move(element);
+                            cell.sequence.store(position + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (difference < 0)
+                        return false;
+                    else
+                        position = _tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            bool try_pop(element_type &element)
+            {
+                std::size_t position = _head.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    _cell &cell = _cells[position & _mask];
+                    std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                    auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+                    if (difference == 0)
+                    {
+                        if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            element = std::move(cell.data);
+                            cell.sequence.store(position + _mask + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (difference < 0)
+                        return false;
+                    else
+                        position = _head.load(std::memory_order_relaxed);
+                }
+            }
+
+        private:
+            std::unique_ptr<_cell[]> _cells;
+            std::size_t _mask;
+            alignas(64) std::atomic<std::size_t> _tail{0};
+            alignas(64) std::atomic<std::size_t> _head{0};
+        };
+
+        // log-scaled latency buckets, four per power of two nanoseconds
+        class _latency_histogram
+        {
+        public:
+            static constexpr size_type bucket_count = 160;
+
+            void record(std::chrono::nanoseconds latency) noexcept
+            {
+                double ns = static_cast<double>(latency.count());
+                size_type bucket = ns < 1.0 ? 0 : static_cast<size_type>(4.0 * std::log2(ns)) + 1;
+                if (bucket >= bucket_count)
+                    bucket = bucket_count - 1;
+                _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // upper bound of the bucket holding the p-th quantile, 0 < p <= 1
+            std::chrono::nanoseconds percentile(double p) const noexcept
+            {
+                std::array<std::uint64_t, bucket_count> counts;
+                std::uint64_t total = 0;
+                for (size_type i = 0; i < bucket_count; ++i)
+                    total += counts[i] = _buckets[i].load(std::memory_order_relaxed);
+                if (total == 0)
+                    return std::chrono::nanoseconds{0};
+
+                auto rank = static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(total)));
+                std::uint64_t seen = 0;
+                for (size_type i = 0; i < bucket_count; ++i)
+                {
+                    seen += counts[i];
+                    if (seen >= rank)
+                        return std::chrono::nanoseconds{static_cast<std::int64_t>(std::exp2(i / 4.0))};
+                }
+                return std::chrono::nanoseconds{static_cast<std::int64_t>(std::exp2((bucket_count - 1) / 4.0))};
+            }
+
+        private:
+            std::array<std::atomic<std::uint64_t>, bucket_count> _buckets{};
+        };
+
+        // evaluates f and f' on a pool of pinned workers, requests are queued without locks
+        // and each worker drains up to batch_size of them before touching the queue again
+        template <typename func_tp, typename value_type>
+        class _derivative_service
+        {
+            static_assert(std::is_floating_point<value_type>::value);
+
+        public:
+            typedef _dual_number<value_type> result_type;
+            typedef std::function<void(result_type)> callback_type;
+            static constexpr size_type batch_size = 8;
+
+            _derivative_service(func_tp f, size_type workers, std::size_t queue_capacity, bool pin_workers)
+                : _function(std::move(f)), _queue{queue_capacity}
+            {
+                workers = utility::thread_count(workers);
+                _workers.reserve(workers);
+                // a failed spawn stops and joins the workers already running before rethrowing,
+                // destroying a joinable std::thread would terminate
+                try
+                {
+                    for (size_type i = 0; i < workers; ++i)
+                    {
+                        _workers.emplace_back([this]
+                                              { _work(); });
+                        if (pin_workers)
+                            _pin(_workers.back(), i);
+                    }
+                }
+                catch (...)
+                {
+                    _stopping.store(true, std::memory_order_release);
+                    for (auto &worker : _workers)
+                        worker.join();
+                    throw;
+                }
+            }
+
+            _derivative_service(const _derivative_service &) = delete;
+            _derivative_service &operator=(const _derivative_service &) = delete;
+
+            // queued requests are still served
+            ~_derivative_service()
+            {
+                _stopping.store(true, std::memory_order_release);
+                for (auto &worker : _workers)
+                    worker.join();
+            }
+
+            // false when the queue is full
+            bool try_submit(value_type x, std::future<result_type> &result)
+            {
+                _request request{x, std::chrono::steady_clock::now(), std::promise<result_type>{}, callback_type{}};
+                auto future = request.promise.get_future();
+                if (!_queue.try_push(request))
+                    return false;
+                result = std::move(future);
+                return true;
+            }
+
+            bool try_submit(value_type x, callback_type callback)
+            {
+                _request request{x, std::chrono::steady_clock::now(), std::promise<result_type>{}, std::move(callback)};
+                return _queue.try_push(request);
+            }
+
+            // waits for room in the queue
+            std::future<result_type> submit(value_type x)
+            {
+                std::future<result_type> result;
+                for (size_type spins = 0; !try_submit(x, result); ++spins)
+                    _backoff(spins);
+                return result;
+            }
+
+            // callback runs on a worker thread and must not throw,
+            // it receives NaN when f throws
+            void submit(value_type x, callback_type callback)
+            {
+                _request request{x, std::chrono::steady_clock::now(), std::promise<result_type>{}, std::move(callback)};
+                for (size_type spins = 0; !_queue.try_push(request); ++spins)
+                    _backoff(spins);
+            }
+
+            // time from submission to completion
+            std::chrono::nanoseconds latency_p50() const noexcept { return _latency.percentile(0.50); }
+            std::chrono::nanoseconds latency_p99() const noexcept { return _latency.percentile(0.99); }
+            std::chrono::nanoseconds latency_percentile(double p) const noexcept { return _latency.percentile(p); }
+
+        private:
+            struct _request
+            {
+                value_type x;
+                std::chrono::steady_clock::time_point submitted;
+                std::promise<result_type> promise;
+                callback_type callback;
+            };
+
+            static void _backoff(size_type spins)
+            {
+                if (spins < 64)
+                    return;
+                if (spins < 128)
+                    std::this_thread::yield();
+                else
+                    std::this_thread::sleep_for(std::chrono::microseconds{50});
+            }
+
+            static void _pin(std::thread &worker, size_type index)
+            {
+#ifdef __linux__
+                cpu_set_t cpus;
+                CPU_ZERO(&cpus);
+                CPU_SET(index % utility::thread_count(), &cpus);
+                pthread_setaffinity_np(worker.native_handle(), sizeof(cpus), &cpus);
+#else
+                (void)worker;
+                (void)index;
+#endif
+            }
+
+            void _work()
+            {
+                std::array<_request, batch_size> batch;
+                std::array<result_type, batch_size> results;
+                std::array<std::exception_ptr, batch_size> errors;
+                for (size_type idle = 0;;)
+                {
+                    size_type count = 0;
+                    while (count < batch_size && _queue.try_pop(batch[count]))
+                        ++count;
+                    if (count == 0)
+                    {
+                        if (_stopping.load(std::memory_order_acquire))
+                            return;
+                        _backoff(idle++);
+                        continue;
+                    }
+                    idle = 0;
+
+                    for (size_type i = 0; i < count; ++i)
+                    {
+                        errors[i] = nullptr;
+                        try
+                        {
+                            results[i] = _function(_dual_number<value_type>{batch[i].x, 1.0});
+                        }
+                        catch (...)
+                        {
+                            errors[i] = std::current_exception();
+                            results[i] = result_type{std::nan(""), std::nan("")};
+                        }
+                    }
+                    for (size_type i = 0; i < count; ++i)
+                    {
+                        if (batch[i].callback)
+                            batch[i].callback(results[i]);
+                        else if (errors[i])
+                            batch[i].promise.set_exception(errors[i]);
+                        else
+                            batch[i].promise.set_value(results[i]);
+                        _latency.record(std::chrono::steady_clock::now() - batch[i].submitted);
+                        batch[i].callback = callback_type{};
+                    }
+                }
+            }
+
+            func_tp _function;
+            _mpmc_queue<_request> _queue;
+            _latency_histogram _latency;
+            std::atomic<bool> _stopping{false};
+            std::vector<std::thread> _workers;
+        };
+    } // namespace math::calculus::details
+
+    // workers = 0 starts one worker per hardware thread
+    template <typename value_type = math::real, typename func_tp>
+    auto derivative_service(func_tp f, size_type workers = 0,
+                            std::size_t queue_capacity = 1024, bool pin_workers = true)
+    {
+        return std::make_unique<details::_derivative_service<func_tp, value_type>>(
+            std::move(f), workers, queue_capacity, pin_workers);
+    }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_FO_DERIVATIVE_SERVICE_HPP
\ No newline at end of file
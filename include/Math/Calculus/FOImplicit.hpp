@@ -0,0 +1,119 @@
+#ifndef MATH_CALCULUS_FO_IMPLICIT_HPP
+#define MATH_CALCULUS_FO_IMPLICIT_HPP
+
+#include "Config.hpp"
+
+#include "Algebra/Factorization.hpp"
+#include "FOAutoDiff.hpp"
+#include "FOJacobianProduct.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// F maps (std::array<_dual_number, n> x, std::array<_dual_number, m> p) to std::array<_dual_number, n>,
+// x* solves F(x*, p) = 0 and comes from any solver, which is never differentiated itself
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace details
+    {
+        template <typename value_type, std::size_t n>
+        void _constant_dual_array(_dual_array<value_type, n> &dx, const std::array<value_type, n> &x) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                dx[i].real = x[i];
+                dx[i].dual = value_type{};
+            }
+        }
+
+        template <typename func_tp, typename value_type, std::size_t n, std::size_t m>
+        using _residual_result_t = std::decay_t<decltype(std::declval<func_tp &>()(
+            std::declval<const _dual_array<value_type, n> &>(),
+            std::declval<const _dual_array<value_type, m> &>()))>;
+
+        // dF/dx at (x, p) into n x n row-major jx, one dual evaluation per column
+        template <typename func_tp, typename value_type, std::size_t n, std::size_t m>
+        void _residual_jacobian_x(func_tp &residual, const std::array<value_type, n> &x,
+                                  const std::array<value_type, m> &p, value_type *jx)
+        {
+            static_assert(std::tuple_size<_residual_result_t<func_tp, value_type, n, m>>::value == n,
+                          "F needs as many equations as unknowns");
+            _dual_array<value_type, n> dx;
+            _dual_array<value_type, m> dp;
+            _constant_dual_array(dp, p);
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                _seed_dual_array(dx, x, j);
+                auto r = residual(static_cast<const _dual_array<value_type, n> &>(dx),
+                                  static_cast<const _dual_array<value_type, m> &>(dp));
+                for (std::size_t i = 0; i < n; ++i)
+                    jx[i * n + j] = r[i].dual;
+            }
+        }
+    } // namespace math::calculus::details
+
+    // dx*/dp as n x m row-major, entry (i, j) is dx*_i / dp_j
+    // from dF/dx * dx*/dp = -dF/dp: n + m dual evaluations of F and one LU solve with m right-hand sides,
+    // the result is exact for the F(x*, p) it is given, so it is as accurate as x* is converged
+    template <typename func_tp, typename value_type, std::size_t n, std::size_t m>
+    std::array<value_type, n * m> implicit_derivative(func_tp residual,
+                                                      const std::array<value_type, n> &x_star,
+                                                      const std::array<value_type, m> &p)
+    {
+        std::vector<value_type> jx(n * n), rhs(n * m);
+        std::array<size_type, n> pivot;
+        details::_residual_jacobian_x(residual, x_star, p, jx.data());
+
+        details::_dual_array<value_type, n> dx;
+        details::_dual_array<value_type, m> dp;
+        details::_constant_dual_array(dx, x_star);
+        for (std::size_t k = 0; k < m; ++k)
+        {
+            details::_seed_dual_array(dp, p, k);
+            auto r = residual(static_cast<const details::_dual_array<value_type, n> &>(dx),
+                              static_cast<const details::_dual_array<value_type, m> &>(dp));
+            for (std::size_t i = 0; i < n; ++i)
+                rhs[i * m + k] = -r[i].dual;
+        }
+
+        algebra::details::_lu_factorize(jx.data(), pivot.data(), n);
+        algebra::details::_lu_solve(jx.data(), pivot.data(), n, rhs.data(), m);
+        std::array<value_type, n * m> dx_dp;
+        std::copy(rhs.begin(), rhs.end(), dx_dp.begin());
+        return dx_dp;
+    }
+
+    // dx*/dp * dp for a single direction, n + 1 dual evaluations of F
+    template <typename func_tp, typename value_type, std::size_t n, std::size_t m>
+    std::array<value_type, n> implicit_derivative(func_tp residual,
+                                                  const std::array<value_type, n> &x_star,
+                                                  const std::array<value_type, m> &p,
+                                                  const std::array<value_type, m> &direction)
+    {
+        std::vector<value_type> jx(n * n);
+        std::array<size_type, n> pivot;
+        details::_residual_jacobian_x(residual, x_star, p, jx.data());
+
+        details::_dual_array<value_type, n> dx;
+        details::_dual_array<value_type, m> dp;
+        details::_constant_dual_array(dx, x_star);
+        details::_seed_dual_array(dp, p, direction.data());
+        auto r = residual(static_cast<const details::_dual_array<value_type, n> &>(dx),
+                          static_cast<const details::_dual_array<value_type, m> &>(dp));
+        std::array<value_type, n> dx_star;
+        for (std::size_t i = 0; i < n; ++i)
+            dx_star[i] = -r[i].dual;
+
+        algebra::details::_lu_factorize(jx.data(), pivot.data(), n);
+        algebra::details::_lu_solve(jx.data(), pivot.data(), n, dx_star.data(), 1);
+        return dx_star;
+    }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_FO_IMPLICIT_HPP
@@ -0,0 +1,165 @@
+#ifndef MATH_CALCULUS_FO_INCREMENTAL_HPP
+#define MATH_CALCULUS_FO_INCREMENTAL_HPP
+
+#include "Config.hpp"
+
+#include "FOAutoDiff.hpp"
+#include "Tape.hpp"
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace details
+    {
+        template <typename value_type>
+        size_type _output_index(_tape<value_type> &, const _recorded_number<value_type> &result)
+        {
+            return result.index();
+        }
+
+        // f does not depend on its inputs
+        template <typename value_type>
+        size_type _output_index(_tape<value_type> &tape, value_type result)
+        {
+            return tape.constant(result).index();
+        }
+
+        // records f once, later calls only recompute the nodes downstream of changed inputs,
+        // the tape is recorded again when a comparison on recorded values flips
+        template <typename func_tp, typename value_type, size_type var_count>
+        class _incremental_derivative
+        {
+            static_assert(std::is_floating_point<value_type>::value);
+
+        public:
+            explicit _incremental_derivative(func_tp f) : _function(std::move(f)) {}
+
+            // f(x) and its derivative along direction; a kernel that throws leaves the tape half updated,
+            // so it is dropped and the next call records again
+            _dual_number<value_type> evaluate(const std::array<value_type, var_count> &x,
+                                              const std::array<value_type, var_count> &direction)
+            {
+                try
+                {
+                    if (_history.size() == 0 || !_replay(x, direction))
+                        _record(x, direction);
+                }
+                catch (...)
+                {
+                    _history.clear();
+                    throw;
+                }
+                const auto &output = _history[_output];
+                return _dual_number<value_type>{output.value, output.tangent};
+            }
+
+            // same as first_order_derivative<pos>
+            template <int pos, typename... var_tp>
+            value_type derivative(var_tp... vars)
+            {
+                static_assert(sizeof...(var_tp) == var_count);
+                std::array<value_type, var_count> direction{};
+                direction[pos] = 1.0;
+                return evaluate(std::array<value_type, var_count>{static_cast<value_type>(vars)...}, direction).dual;
+            }
+
+            // work done by the last call, in nodes, and the number of full recordings so far
+            size_type recomputed() const noexcept { return _recomputed; }
+            size_type recordings() const noexcept { return _recordings; }
+
+        private:
+            template <std::size_t... index>
+            size_type _trace(const std::array<value_type, var_count> &x,
+                             const std::array<value_type, var_count> &direction,
+                             std::index_sequence<index...>)
+            {
+                std::array<_recorded_number<value_type>, var_count> inputs{_history.input(x[index], direction[index])...};
+                return _output_index(_history, _function(inputs[index]...));
+            }
+
+            void _record(const std::array<value_type, var_count> &x,
+                         const std::array<value_type, var_count> &direction)
+            {
+                _history.clear();
+                _output = _trace(x, direction, std::make_index_sequence<var_count>{});
+                _changed.assign(_history.size(), 0);
+                _epoch = 0;
+                _recomputed = _history.size();
+                ++_recordings;
+            }
+
+            // false when the control flow diverges from the recorded one
+            bool _replay(const std::array<value_type, var_count> &x,
+                         const std::array<value_type, var_count> &direction)
+            {
+                ++_epoch;
+                _recomputed = 0;
+                size_type first = _history.size();
+                for (size_type i = 0; i < var_count; ++i)
+                {
+                    auto &node = _history[i];
+                    if (node.value != x[i] || node.tangent != direction[i])
+                    {
+                        node.value = x[i];
+                        node.tangent = direction[i];
+                        _changed[i] = _epoch;
+                        first = var_count;
+                    }
+                }
+
+                for (size_type i = first; i < _history.size(); ++i)
+                {
+                    auto &node = _history[i];
+                    if (node.op == _tape_op::input || node.op == _tape_op::constant)
+                        continue;
+                    if (_changed[node.lhs] != _epoch && _changed[node.rhs] != _epoch)
+                        continue;
+
+                    ++_recomputed;
+                    auto result = _evaluate_tape_op(
+                        node.op,
+                        _dual_number<value_type>{_history[node.lhs].value, _history[node.lhs].tangent},
+                        _dual_number<value_type>{_history[node.rhs].value, _history[node.rhs].tangent});
+                    if (_is_guard(node.op))
+                    {
+                        if (result.real != node.value)
+                            return false;
+                        continue;
+                    }
+                    // an unchanged result stops the propagation
+                    if (result.real != node.value || result.dual != node.tangent)
+                    {
+                        node.value = result.real;
+                        node.tangent = result.dual;
+                        _changed[i] = _epoch;
+                    }
+                }
+                return true;
+            }
+
+            func_tp _function;
+            _tape<value_type> _history;
+            size_type _output = 0;
+            std::vector<std::uint32_t> _changed;
+            std::uint32_t _epoch = 0;
+            size_type _recomputed = 0;
+            size_type _recordings = 0;
+        };
+    } // namespace math::calculus::details
+
+    // f takes var_count arguments and may branch only through comparisons of its arguments and intermediates
+    template <size_type var_count, typename value_type = math::real, typename func_tp>
+    auto incremental(func_tp f)
+    {
+        return details::_incremental_derivative<func_tp, value_type, var_count>{std::move(f)};
+    }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_FO_INCREMENTAL_HPP
\ No newline at end of file
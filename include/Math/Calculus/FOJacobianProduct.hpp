@@ -0,0 +1,127 @@
+#ifndef MATH_CALCULUS_FO_JACOBIAN_PRODUCT_HPP
+#define MATH_CALCULUS_FO_JACOBIAN_PRODUCT_HPP
+
+#include "Config.hpp"
+
+#include "FOAutoDiff.hpp"
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// f maps std::array<_dual_number, n> to std::array<_dual_number, m>
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace details
+    {
+        template <typename value_type, std::size_t n>
+        using _dual_array = std::array<_dual_number<value_type>, n>;
+
+        template <typename func_tp, typename value_type, std::size_t n>
+        using _dual_array_result_t = std::decay_t<decltype(std::declval<func_tp &>()(
+            std::declval<_dual_array<value_type, n> &>()))>;
+
+        template <typename func_tp, typename value_type, std::size_t n>
+        struct _output_size
+            : std::tuple_size<_dual_array_result_t<func_tp, value_type, n>>
+        {
+        };
+
+        // x + v * epsilon, v is read from n contiguous values
+        template <typename value_type, std::size_t n>
+        void _seed_dual_array(_dual_array<value_type, n> &dx,
+                              const std::array<value_type, n> &x,
+                              const value_type *v) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                dx[i].real = x[i];
+                dx[i].dual = v[i];
+            }
+        }
+
+        // x + e_pos * epsilon
+        template <typename value_type, std::size_t n>
+        void _seed_dual_array(_dual_array<value_type, n> &dx,
+                              const std::array<value_type, n> &x,
+                              std::size_t pos) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                dx[i].real = x[i];
+                dx[i].dual = value_type{};
+            }
+            dx[pos].dual = 1.0;
+        }
+    } // namespace math::calculus::details
+
+    // J(x) * v in a single dual evaluation of f
+    template <typename func_tp, typename value_type, std::size_t n>
+    auto jvp(func_tp f, const std::array<value_type, n> &x, const std::array<value_type, n> &v)
+    {
+        details::_dual_array<value_type, n> dx;
+        details::_seed_dual_array(dx, x, v.data());
+        auto dy = f(dx);
+        std::array<value_type, std::tuple_size<decltype(dy)>::value> jv;
+        for (std::size_t i = 0; i < jv.size(); ++i)
+            jv[i] = dy[i].dual;
+        return jv;
+    }
+
+    // count products J(x) * v_k, one dual evaluation each
+    // vs holds count directions of length n back to back, jvs receives count products of length m
+    template <typename func_tp, typename value_type, std::size_t n>
+    void jvp(func_tp f, const std::array<value_type, n> &x,
+             const value_type *vs, value_type *jvs, size_type count)
+    {
+        static constexpr std::size_t m = details::_output_size<func_tp, value_type, n>::value;
+        details::_dual_array<value_type, n> dx;
+        for (size_type k = 0; k < count; ++k)
+        {
+            details::_seed_dual_array(dx, x, vs + k * n);
+            auto dy = f(dx);
+            for (std::size_t i = 0; i < m; ++i)
+                jvs[k * m + i] = dy[i].dual;
+        }
+    }
+
+    // count products v_k^T * J(x), accumulated one column J(x) * e_j at a time so J is never stored
+    // costs n dual evaluations of f for any count, forward mode has no cheaper route to row products
+    // vs holds count vectors of length m back to back, vjs receives count products of length n
+    template <typename func_tp, typename value_type, std::size_t n>
+    void vjp(func_tp f, const std::array<value_type, n> &x,
+             const value_type *vs, value_type *vjs, size_type count)
+    {
+        static constexpr std::size_t m = details::_output_size<func_tp, value_type, n>::value;
+        details::_dual_array<value_type, n> dx;
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            details::_seed_dual_array(dx, x, j);
+            auto dy = f(dx);
+            for (size_type k = 0; k < count; ++k)
+            {
+                value_type sum = 0.0;
+                for (std::size_t i = 0; i < m; ++i)
+                    sum += vs[k * m + i] * dy[i].dual;
+                vjs[k * n + j] = sum;
+            }
+        }
+    }
+
+    // v^T * J(x)
+    template <typename func_tp, typename value_type, std::size_t n, std::size_t m>
+    std::array<value_type, n> vjp(func_tp f, const std::array<value_type, n> &x, const std::array<value_type, m> &v)
+    {
+        static_assert(m == details::_output_size<func_tp, value_type, n>::value,
+                      "v must have one entry per output of f at math::calculus::vjp");
+        std::array<value_type, n> vj;
+        vjp(f, x, v.data(), vj.data(), 1);
+        return vj;
+    }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_FO_JACOBIAN_PRODUCT_HPP
\ No newline at end of file
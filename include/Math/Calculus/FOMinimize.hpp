@@ -0,0 +1,429 @@
+#ifndef MATH_CALCULUS_FO_MINIMIZE_HPP
+#define MATH_CALCULUS_FO_MINIMIZE_HPP
+
+#include "Config.hpp"
+
+#include "FOAutoDiff.hpp"
+#include "FOJacobianProduct.hpp"
+#include "FOMultiDual.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+// f maps const std::array<number, n> & to number and is called on two number types:
+// _multi_dual_number<value_type, lanes> for the value and lanes gradient components per pass,
+// and _dual_number<value_type> seeded with the search direction for the line search trials;
+// a gradient takes n / lanes passes of f whose operations each carry lanes tangents,
+// so it costs about as much as n forward passes
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace details
+    {
+        template <typename value_type>
+        struct _lbfgs_options
+        {
+            // converged once no free gradient component exceeds gradient_tolerance in magnitude
+            value_type gradient_tolerance = 1e-8;
+            size_type max_iterations = 1000;
+            // sufficient decrease and curvature constants of the strong Wolfe conditions
+            value_type c1 = 1e-4;
+            value_type c2 = 0.9;
+            size_type max_line_search = 40;
+        };
+
+        template <typename value_type, std::size_t n>
+        struct _lbfgs_result
+        {
+            std::array<value_type, n> x;
+            value_type value;
+            std::array<value_type, n> gradient;
+            size_type iterations;
+            // calls of f on either number type
+            size_type evaluations;
+            bool converged;
+        };
+
+        // projected L-BFGS, a variable at a bound whose gradient pushes outwards is held fixed and the
+        // two-loop recursion runs on the free variables; steps stop at the first bound they reach,
+        // so every line search is along a feasible ray and the strong Wolfe conditions apply unchanged.
+        // all storage is allocated once by the constructor
+        template <typename func_tp, typename value_type, std::size_t n, size_type memory, std::size_t lanes>
+        class _lbfgs_solver
+        {
+            static_assert(memory > 0, "lbfgs needs at least one correction pair");
+            static_assert(lanes > 0, "lbfgs needs at least one gradient lane");
+
+            static constexpr std::size_t _lanes = lanes < n ? lanes : n;
+            typedef _multi_dual_number<value_type, _lanes> _lane_number;
+            typedef std::array<_lane_number, n> _lane_inputs;
+
+            // a point on the search ray with phi(alpha) = f(x + alpha d) and phi'(alpha)
+            struct _trial
+            {
+                value_type alpha;
+                value_type value;
+                value_type slope;
+            };
+
+        public:
+            _lbfgs_solver(func_tp &f, const std::array<value_type, n> &lower, const std::array<value_type, n> &upper,
+                          const _lbfgs_options<value_type> &options)
+                : _f(f), _lower(lower), _upper(upper), _options(options),
+                  _seeded(std::make_unique<_lane_inputs>()), _s(memory * n), _y(memory * n), _rho(memory), _alpha(memory)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                    if (!(lower[i] <= upper[i]))
+                        throw std::runtime_error("lower > upper at math::calculus::lbfgs");
+            }
+
+            _lbfgs_result<value_type, n> run(const std::array<value_type, n> &start)
+            {
+                _lbfgs_result<value_type, n> result{};
+                for (std::size_t i = 0; i < n; ++i)
+                    _x[i] = std::min(std::max(start[i], _lower[i]), _upper[i]);
+                _value = _gradient_pass(_x, _g, result.evaluations);
+
+                for (; result.iterations < _options.max_iterations; ++result.iterations)
+                {
+                    if (_mark_free() <= _options.gradient_tolerance)
+                    {
+                        result.converged = true;
+                        break;
+                    }
+                    value_type slope = _direction();
+                    if (!(slope < 0.0))
+                    {
+                        _count = 0;
+                        slope = _direction();
+                    }
+
+                    _trial accepted;
+                    bool decreased = _line_search(slope, accepted, result.evaluations);
+                    if (!decreased && _count > 0)
+                    {
+                        // the quasi-Newton direction failed, retry once along the steepest descent
+                        _count = 0;
+                        decreased = _line_search(_direction(), accepted, result.evaluations);
+                    }
+                    if (!decreased)
+                        break;
+
+                    _step(accepted.alpha);
+                    if (accepted.alpha != _gradient_alpha)
+                    {
+                        _value = _gradient_pass(_x_new, _g_new, result.evaluations);
+                    }
+                    else
+                        _value = accepted.value;
+                    _push_pair();
+                    _x = _x_new;
+                    _g = _g_new;
+                }
+
+                result.x = _x;
+                result.value = _value;
+                result.gradient = _g;
+                return result;
+            }
+
+        private:
+            // f and its gradient at x, each pass seeds the next _lanes inputs and leaves the others constant;
+            // the inputs live on the heap since n * (_lanes + 1) values may not fit on the stack
+            value_type _gradient_pass(const std::array<value_type, n> &x, std::array<value_type, n> &g,
+                                      size_type &evaluations)
+            {
+                _lane_inputs &seeded = *_seeded;
+                for (std::size_t i = 0; i < n; ++i)
+                    seeded[i] = _lane_number{x[i]};
+                value_type value = 0.0;
+                for (std::size_t first = 0; first < n; first += _lanes)
+                {
+                    std::size_t last = std::min(first + _lanes, n);
+                    for (std::size_t i = first; i < last; ++i)
+                        seeded[i] = _lane_number{x[i], i - first};
+                    _lane_number y = _f(static_cast<const _lane_inputs &>(seeded));
+                    ++evaluations;
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        g[i] = y.dual[i - first];
+                        seeded[i] = _lane_number{x[i]};
+                    }
+                    value = y.real;
+                }
+                return value;
+            }
+
+            // clamped x + alpha d into _x_new
+            void _step(value_type alpha) noexcept
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                    _x_new[i] = std::min(std::max(_x[i] + alpha * _d[i], _lower[i]), _upper[i]);
+            }
+
+            // phi(alpha) and phi'(alpha) at _x_new, the first trial of a search takes the full gradient
+            // since an accepted first step needs it anyway, later trials only the directional derivative
+            _trial _evaluate(value_type alpha, bool first, size_type &evaluations)
+            {
+                _step(alpha);
+                _trial trial{alpha, 0.0, 0.0};
+                if (first)
+                {
+                    _gradient_alpha = alpha;
+                    trial.value = _gradient_pass(_x_new, _g_new, evaluations);
+                    for (std::size_t i = 0; i < n; ++i)
+                        trial.slope += _g_new[i] * _d[i];
+                }
+                else
+                {
+                    _seed_dual_array(_ray, _x_new, _d.data());
+                    _dual_number<value_type> y = _f(static_cast<const _dual_array<value_type, n> &>(_ray));
+                    ++evaluations;
+                    trial.value = y.real;
+                    trial.slope = y.dual;
+                }
+                return trial;
+            }
+
+            // free[i] unless x[i] sits at a bound the gradient pushes against, returns the largest free |g[i]|
+            value_type _mark_free() noexcept
+            {
+                value_type largest = 0.0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    _free[i] = !((_x[i] <= _lower[i] && _g[i] > 0.0) || (_x[i] >= _upper[i] && _g[i] < 0.0));
+                    if (_free[i])
+                        largest = std::max(largest, std::abs(_g[i]));
+                }
+                return largest;
+            }
+
+            value_type _free_dot(const value_type *a, const value_type *b) const noexcept
+            {
+                value_type sum = 0.0;
+                for (std::size_t i = 0; i < n; ++i)
+                    if (_free[i])
+                        sum += a[i] * b[i];
+                return sum;
+            }
+
+            // d = -H g on the free variables by the two-loop recursion over the ring buffer, returns g . d;
+            // without history the first step has length at most 1
+            value_type _direction() noexcept
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                    _d[i] = _free[i] ? -_g[i] : value_type{};
+
+                value_type scale = 1.0;
+                if (_count == 0)
+                    scale = std::min(value_type{1.0}, value_type{1.0} / std::sqrt(_free_dot(_d.data(), _d.data())));
+                else
+                {
+                    for (size_type k = 0; k < _count; ++k)
+                    {
+                        size_type slot = (_head + memory - 1 - k) % memory;
+                        const value_type *s = _s.data() + slot * n, *y = _y.data() + slot * n;
+                        _alpha[slot] = _rho[slot] * _free_dot(s, _d.data());
+                        for (std::size_t i = 0; i < n; ++i)
+                            _d[i] -= _alpha[slot] * y[i];
+                    }
+                    size_type last = (_head + memory - 1) % memory;
+                    const value_type *s_last = _s.data() + last * n, *y_last = _y.data() + last * n;
+                    value_type yy = _free_dot(y_last, y_last);
+                    if (yy > 0.0)
+                        scale = _free_dot(s_last, y_last) / yy;
+                    for (std::size_t i = 0; i < n; ++i)
+                        _d[i] *= scale;
+                    scale = 1.0;
+                    for (size_type k = _count; k-- > 0;)
+                    {
+                        size_type slot = (_head + memory - 1 - k) % memory;
+                        const value_type *s = _s.data() + slot * n, *y = _y.data() + slot * n;
+                        value_type beta = _rho[slot] * _free_dot(y, _d.data());
+                        for (std::size_t i = 0; i < n; ++i)
+                            _d[i] += (_alpha[slot] - beta) * s[i];
+                    }
+                }
+                value_type slope = 0.0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    _d[i] = _free[i] ? scale * _d[i] : value_type{};
+                    slope += _g[i] * _d[i];
+                }
+                return slope;
+            }
+
+            // s = x_new - x and y = g_new - g enter the ring buffer when s . y > 0 keeps H positive definite
+            void _push_pair() noexcept
+            {
+                value_type *s = _s.data() + _head * n, *y = _y.data() + _head * n;
+                value_type sy = 0.0, yy = 0.0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    s[i] = _x_new[i] - _x[i];
+                    y[i] = _g_new[i] - _g[i];
+                    sy += s[i] * y[i];
+                    yy += y[i] * y[i];
+                }
+                if (!(sy > std::numeric_limits<value_type>::epsilon() * yy))
+                    return;
+                _rho[_head] = 1.0 / sy;
+                _head = (_head + 1) % memory;
+                _count = std::min(_count + 1, memory);
+            }
+
+            // largest alpha keeping x + alpha d inside the bounds
+            value_type _max_step() const noexcept
+            {
+                value_type alpha = std::numeric_limits<value_type>::infinity();
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    if (_d[i] < 0.0)
+                        alpha = std::min(alpha, (_lower[i] - _x[i]) / _d[i]);
+                    else if (_d[i] > 0.0)
+                        alpha = std::min(alpha, (_upper[i] - _x[i]) / _d[i]);
+                }
+                return std::max(alpha, value_type{});
+            }
+
+            // strong Wolfe search by bracketing and zoom, Nocedal and Wright algorithms 3.5 and 3.6;
+            // a step cut short by a bound is accepted on sufficient decrease alone
+            bool _line_search(value_type slope, _trial &accepted, size_type &evaluations)
+            {
+                const _trial origin{0.0, _value, slope};
+                _gradient_alpha = -1.0;
+                value_type alpha_max = _max_step();
+                if (!(slope < 0.0) || !(alpha_max > 0.0))
+                    return false;
+
+                _trial previous = origin, current;
+                value_type alpha = std::min(value_type{1.0}, alpha_max);
+                for (size_type k = 0; k < _options.max_line_search; ++k)
+                {
+                    current = _evaluate(alpha, k == 0, evaluations);
+                    if (!_sufficient(origin, current) || (k > 0 && current.value >= previous.value))
+                        return _zoom(origin, previous, current, accepted, evaluations);
+                    if (std::abs(current.slope) <= -_options.c2 * origin.slope || alpha == alpha_max)
+                    {
+                        accepted = current;
+                        return true;
+                    }
+                    if (current.slope >= 0.0)
+                        return _zoom(origin, current, previous, accepted, evaluations);
+                    previous = current;
+                    alpha = std::min(value_type{2.0} * alpha, alpha_max);
+                }
+                return _accept_if_lower(origin, current, accepted);
+            }
+
+            bool _sufficient(const _trial &origin, const _trial &trial) const noexcept
+            {
+                return trial.value <= origin.value + _options.c1 * trial.alpha * origin.slope;
+            }
+
+            // lo satisfies sufficient decrease and has the lowest value so far, the minimizer lies between lo and hi
+            bool _zoom(const _trial &origin, _trial lo, _trial hi, _trial &accepted, size_type &evaluations)
+            {
+                for (size_type k = 0; k < _options.max_line_search; ++k)
+                {
+                    value_type alpha = _cubic_minimizer(lo, hi);
+                    if (alpha == lo.alpha || alpha == hi.alpha)
+                        break;
+                    _trial current = _evaluate(alpha, false, evaluations);
+                    if (!_sufficient(origin, current) || current.value >= lo.value)
+                        hi = current;
+                    else
+                    {
+                        if (std::abs(current.slope) <= -_options.c2 * origin.slope)
+                        {
+                            accepted = current;
+                            return true;
+                        }
+                        if (current.slope * (hi.alpha - lo.alpha) >= 0.0)
+                            hi = lo;
+                        lo = current;
+                    }
+                }
+                return _accept_if_lower(origin, lo, accepted);
+            }
+
+            // fallback when the search runs out, any step with sufficient decrease still makes progress
+            bool _accept_if_lower(const _trial &origin, const _trial &trial, _trial &accepted) const noexcept
+            {
+                if (trial.alpha <= 0.0 || !_sufficient(origin, trial) || !(trial.value < origin.value))
+                    return false;
+                accepted = trial;
+                return true;
+            }
+
+            // minimizer of the cubic matching both values and slopes, kept a tenth of the interval inside,
+            // bisection when the cubic has no minimizer there
+            static value_type _cubic_minimizer(const _trial &a, const _trial &b) noexcept
+            {
+                value_type left = std::min(a.alpha, b.alpha), right = std::max(a.alpha, b.alpha);
+                value_type margin = 0.1 * (right - left);
+                value_type d1 = a.slope + b.slope - 3.0 * (a.value - b.value) / (a.alpha - b.alpha);
+                value_type discriminant = d1 * d1 - a.slope * b.slope;
+                value_type alpha = 0.5 * (left + right);
+                if (discriminant >= 0.0)
+                {
+                    value_type d2 = std::copysign(std::sqrt(discriminant), b.alpha - a.alpha);
+                    value_type candidate = b.alpha - (b.alpha - a.alpha) * (b.slope + d2 - d1) / (b.slope - a.slope + 2.0 * d2);
+                    if (std::isfinite(candidate))
+                        alpha = candidate;
+                }
+                return std::min(std::max(alpha, left + margin), right - margin);
+            }
+
+            func_tp &_f;
+            const std::array<value_type, n> _lower;
+            const std::array<value_type, n> _upper;
+            const _lbfgs_options<value_type> _options;
+
+            std::array<value_type, n> _x, _g, _d, _x_new, _g_new;
+            std::array<bool, n> _free;
+            _dual_array<value_type, n> _ray;
+            std::unique_ptr<_lane_inputs> _seeded;
+            value_type _value = 0.0;
+            // step of the last full gradient pass into _g_new, -1 when the current search has none
+            value_type _gradient_alpha = -1.0;
+
+            // ring buffer of the last memory pairs, slot k holds s and y at [k * n, k * n + n)
+            std::vector<value_type> _s, _y, _rho, _alpha;
+            size_type _head = 0;
+            size_type _count = 0;
+        };
+    } // namespace math::calculus::details
+
+    // minimizes f from x by L-BFGS keeping the last memory correction pairs
+    template <size_type memory = 8, std::size_t lanes = 8, typename func_tp, typename value_type, std::size_t n>
+    details::_lbfgs_result<value_type, n> lbfgs(func_tp f, const std::array<value_type, n> &x,
+                                                const details::_lbfgs_options<value_type> &options = {})
+    {
+        std::array<value_type, n> lower, upper;
+        lower.fill(-std::numeric_limits<value_type>::infinity());
+        upper.fill(std::numeric_limits<value_type>::infinity());
+        details::_lbfgs_solver<func_tp, value_type, n, memory, lanes> solver{f, lower, upper, options};
+        return solver.run(x);
+    }
+
+    // minimizes f over lower <= x <= upper, infinite bounds are allowed and x is projected first
+    template <size_type memory = 8, std::size_t lanes = 8, typename func_tp, typename value_type, std::size_t n>
+    details::_lbfgs_result<value_type, n> lbfgs(func_tp f, const std::array<value_type, n> &x,
+                                                const std::array<value_type, n> &lower,
+                                                const std::array<value_type, n> &upper,
+                                                const details::_lbfgs_options<value_type> &options = {})
+    {
+        details::_lbfgs_solver<func_tp, value_type, n, memory, lanes> solver{f, lower, upper, options};
+        return solver.run(x);
+    }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_FO_MINIMIZE_HPP
@@ -0,0 +1,289 @@
+#ifndef MATH_CALCULUS_FO_MULTI_DUAL_HPP
+#define MATH_CALCULUS_FO_MULTI_DUAL_HPP
+
+#include "Config.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace details
+    {
+        // dual number carrying tangent_count directional derivatives at once,
+        // every operation is one scalar rule applied to a fixed length array, which the compiler vectorizes
+        template <typename value_type = math::real, std::size_t tangent_count = 1>
+        class _multi_dual_number
+        {
+            static_assert(std::is_floating_point<value_type>::value, "_multi_dual_number needs a floating point type");
+            static_assert(tangent_count > 0, "_multi_dual_number needs at least one tangent");
+            typedef _multi_dual_number<value_type, tangent_count> same_type;
+
+        public:
+            typedef value_type type;
+            typedef std::array<value_type, tangent_count> tangent_type;
+
+            value_type real = 0.0;
+            tangent_type dual{};
+
+            _multi_dual_number() = default;
+
+            // constant
+            _multi_dual_number(value_type value) noexcept : real{value} {}
+
+            // input number index, its tangent is seed * e_index
+            _multi_dual_number(value_type value, std::size_t index, value_type seed = 1.0) noexcept : real{value}
+            {
+                dual[index] = seed;
+            }
+
+            value_type derivative(std::size_t index) const noexcept { return dual[index]; }
+
+            // arithmetic group
+
+            same_type &operator+=(const same_type &rhs) noexcept
+            {
+                real += rhs.real;
+                for (std::size_t i = 0; i < tangent_count; ++i)
+                    dual[i] += rhs.dual[i];
+                return *this;
+            }
+
+            same_type &operator+=(value_type scalar) noexcept
+            {
+                real += scalar;
+                return *this;
+            }
+
+            same_type &operator-=(const same_type &rhs) noexcept
+            {
+                real -= rhs.real;
+                for (std::size_t i = 0; i < tangent_count; ++i)
+                    dual[i] -= rhs.dual[i];
+                return *this;
+            }
+
+            same_type &operator-=(value_type scalar) noexcept
+            {
+                real -= scalar;
+                return *this;
+            }
+
+            same_type &operator*=(const same_type &rhs) noexcept
+            {
+                for (std::size_t i = 0; i < tangent_count; ++i)
+                    dual[i] = dual[i] * rhs.real + real * rhs.dual[i];
+                real *= rhs.real;
+                return *this;
+            }
+
+            same_type &operator*=(value_type scalar) noexcept
+            {
+                real *= scalar;
+                for (std::size_t i = 0; i < tangent_count; ++i)
+                    dual[i] *= scalar;
+                return *this;
+            }
+
+            same_type &operator/=(const same_type &rhs) noexcept
+            {
+                value_type inv = 1.0 / rhs.real;
+                real *= inv;
+                for (std::size_t i = 0; i < tangent_count; ++i)
+                    dual[i] = (dual[i] - real * rhs.dual[i]) * inv;
+                return *this;
+            }
+
+            same_type &operator/=(value_type scalar) noexcept
+            {
+                return *this *= 1.0 / scalar;
+            }
+
+            same_type operator-() const noexcept
+            {
+                return _chain(-real, *this, -1.0);
+            }
+
+            friend same_type operator+(same_type lhs, const same_type &rhs) noexcept { return lhs += rhs; }
+            friend same_type operator+(same_type lhs, value_type scalar) noexcept { return lhs += scalar; }
+            friend same_type operator+(value_type scalar, same_type rhs) noexcept { return rhs += scalar; }
+
+            friend same_type operator-(same_type lhs, const same_type &rhs) noexcept { return lhs -= rhs; }
+            friend same_type operator-(same_type lhs, value_type scalar) noexcept { return lhs -= scalar; }
+            friend same_type operator-(value_type scalar, const same_type &rhs) noexcept
+            {
+                return _chain(scalar - rhs.real, rhs, -1.0);
+            }
+
+            friend same_type operator*(same_type lhs, const same_type &rhs) noexcept { return lhs *= rhs; }
+            friend same_type operator*(same_type lhs, value_type scalar) noexcept { return lhs *= scalar; }
+            friend same_type operator*(value_type scalar, same_type rhs) noexcept { return rhs *= scalar; }
+
+            friend same_type operator/(same_type lhs, const same_type &rhs) noexcept { return lhs /= rhs; }
+            friend same_type operator/(same_type lhs, value_type scalar) noexcept { return lhs /= scalar; }
+            friend same_type operator/(value_type scalar, const same_type &rhs) noexcept
+            {
+                value_type inv = 1.0 / rhs.real;
+                return _chain(scalar * inv, rhs, -scalar * inv * inv);
+            }
+
+            // power group
+
+            // x.real != 0
+            friend same_type abs(const same_type &x)
+            {
+                if (x.real == 0.0)
+                    throw std::runtime_error("x.real = 0 at math::abs<_multi_dual_number>");
+                return _chain(std::abs(x.real), x, x.real > 0.0 ? 1.0 : -1.0);
+            }
+
+            friend same_type sq(const same_type &x) noexcept
+            {
+                return _chain(x.real * x.real, x, 2.0 * x.real);
+            }
+
+            friend same_type sqrt(const same_type &x)
+            {
+                if (x.real <= 0.0)
+                    throw std::runtime_error("x.real <= 0 at math::sqrt<_multi_dual_number>");
+                value_type sqrt_xr = std::sqrt(x.real);
+                return _chain(sqrt_xr, x, 0.5 / sqrt_xr);
+            }
+
+            // as for _dual_number: a constant x or p = 0 has a zero tangent,
+            // otherwise x.real = 0 is fine only for natural p >= 1
+            friend same_type pow(const same_type &x, value_type p)
+            {
+                value_type pow_xr = std::pow(x.real, p);
+                if (p == 0.0 || _is_constant(x))
+                    return same_type{pow_xr};
+                if (x.real == 0.0 && (p < 1.0 || p != std::floor(p)))
+                    throw std::runtime_error("x.real = 0 at math::pow_x_n<_multi_dual_number>");
+                return _chain(pow_xr, x, p * std::pow(x.real, p - 1.0));
+            }
+
+            // as for _dual_number: the log(f) term only enters when f > 0, a negative base needs g to be constant,
+            // and at f = 0 only the lanes where f has a tangent get one
+            friend same_type pow(const same_type &f, const same_type &g)
+            {
+                value_type pow_fg = std::pow(f.real, g.real);
+                if (f.real < 0.0 && !_is_constant(g))
+                    throw std::runtime_error("f.real < 0 at math::pow_f_g<_multi_dual_number>");
+                if (f.real == 0.0)
+                {
+                    same_type result{pow_fg};
+                    value_type df = g.real * std::pow(f.real, g.real - 1.0);
+                    for (std::size_t i = 0; i < tangent_count; ++i)
+                        if (f.dual[i] != 0.0)
+                            result.dual[i] = df * f.dual[i];
+                    return result;
+                }
+                value_type dg = f.real > 0.0 ? pow_fg * std::log(f.real) : value_type{};
+                return _combine(pow_fg, f, g.real * std::pow(f.real, g.real - 1.0), g, dg);
+            }
+
+            // exponential and logarithmic group
+
+            friend same_type exp(const same_type &x) noexcept
+            {
+                value_type exp_xr = std::exp(x.real);
+                return _chain(exp_xr, x, exp_xr);
+            }
+
+            friend same_type log(const same_type &x)
+            {
+                if (x.real <= 0.0)
+                    throw std::runtime_error("x.real <= 0 at math::log<_multi_dual_number>");
+                return _chain(std::log(x.real), x, 1.0 / x.real);
+            }
+
+            friend same_type ln(const same_type &x)
+            {
+                return log(x);
+            }
+
+            // trigonometric and hyperbolic group
+
+            friend same_type sin(const same_type &x) noexcept
+            {
+                return _chain(std::sin(x.real), x, std::cos(x.real));
+            }
+
+            friend same_type cos(const same_type &x) noexcept
+            {
+                return _chain(std::cos(x.real), x, -std::sin(x.real));
+            }
+
+            friend same_type tanh(const same_type &x) noexcept
+            {
+                value_type tanh_xr = std::tanh(x.real);
+                return _chain(tanh_xr, x, 1.0 - tanh_xr * tanh_xr);
+            }
+
+            // miscellaneous group
+
+            friend same_type fma(const same_type &x, const same_type &y, const same_type &z) noexcept
+            {
+                same_type result = _combine(std::fma(x.real, y.real, z.real), x, y.real, y, x.real);
+                for (std::size_t i = 0; i < tangent_count; ++i)
+                    result.dual[i] += z.dual[i];
+                return result;
+            }
+
+            // ties take the tangent of x, so a payoff max(s - k, 0) is differentiated as s - k at the kink
+            friend same_type fmin(const same_type &x, const same_type &y) noexcept
+            {
+                return (y.real < x.real || std::isnan(x.real)) ? y : x;
+            }
+
+            friend same_type fmax(const same_type &x, const same_type &y) noexcept
+            {
+                return (y.real > x.real || std::isnan(x.real)) ? y : x;
+            }
+
+            friend std::ostream &operator<<(std::ostream &os, const same_type &x)
+            {
+                os << "(" << x.real << ", {";
+                for (std::size_t i = 0; i < tangent_count; ++i)
+                    os << (i == 0 ? "" : ", ") << x.dual[i];
+                return os << "})";
+            }
+
+        private:
+            static bool _is_constant(const same_type &x) noexcept
+            {
+                for (std::size_t i = 0; i < tangent_count; ++i)
+                    if (x.dual[i] != 0.0)
+                        return false;
+                return true;
+            }
+
+            // result of a unary function, its tangent is scale * x'
+            static same_type _chain(value_type real, const same_type &x, value_type scale) noexcept
+            {
+                same_type result{real};
+                for (std::size_t i = 0; i < tangent_count; ++i)
+                    result.dual[i] = scale * x.dual[i];
+                return result;
+            }
+
+            // result of a binary function, its tangent is x_scale * x' + y_scale * y'
+            static same_type _combine(value_type real, const same_type &x, value_type x_scale,
+                                      const same_type &y, value_type y_scale) noexcept
+            {
+                same_type result{real};
+                for (std::size_t i = 0; i < tangent_count; ++i)
+                    result.dual[i] = x_scale * x.dual[i] + y_scale * y.dual[i];
+                return result;
+            }
+        };
+    } // namespace math::calculus::details
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_FO_MULTI_DUAL_HPP
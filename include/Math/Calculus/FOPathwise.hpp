@@ -0,0 +1,151 @@
+#ifndef MATH_CALCULUS_FO_PATHWISE_HPP
+#define MATH_CALCULUS_FO_PATHWISE_HPP
+
+#include "Config.hpp"
+
+#include "Algebra/DualMatrix.hpp"
+#include "FOMultiDual.hpp"
+#include "Utility/Parallel.hpp"
+#include "Utility/Philox.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// path(parameters, stream) simulates one path from the normals of its philox_stream and returns the
+// discounted payoff as a _multi_dual_number, the parameters arrive seeded with the unit tangents,
+// so one evaluation per path yields the payoff and its derivatives with respect to all of them
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace details
+    {
+        // paths per reduction block, blocks never depend on the thread count
+        static constexpr std::uint64_t _path_block = 1024;
+
+        template <typename value_type, std::size_t n>
+        struct _pathwise_estimate
+        {
+            // mean payoff and the standard error of that mean
+            value_type value;
+            value_type value_error;
+            // mean pathwise derivatives and their standard errors
+            std::array<value_type, n> sensitivities;
+            std::array<value_type, n> sensitivity_errors;
+        };
+
+        // lane 0 is the payoff, lane 1 + i its derivative with respect to parameter i;
+        // a block is summed in two passes over its paths, sums[lane * blocks + b] and
+        // squares[lane * blocks + b] receive its sum and its sum of squared deviations from the block mean
+        template <typename func_tp, typename value_type, std::size_t n>
+        void _pathwise_block(func_tp &path, const std::array<_multi_dual_number<value_type, n>, n> &parameters,
+                             std::uint64_t seed, std::uint64_t first, std::uint64_t last,
+                             std::vector<value_type> &samples, value_type *sums, value_type *squares, size_type blocks)
+        {
+            static constexpr std::size_t lanes = n + 1;
+            std::uint64_t count = last - first;
+            for (std::uint64_t k = 0; k < count; ++k)
+            {
+                utility::philox_stream<value_type> stream{seed, first + k};
+                _multi_dual_number<value_type, n> payoff = path(parameters, stream);
+                samples[k * lanes] = payoff.real;
+                std::copy(payoff.dual.begin(), payoff.dual.end(), samples.begin() + k * lanes + 1);
+            }
+
+            for (std::size_t lane = 0; lane < lanes; ++lane)
+            {
+                value_type sum = 0.0;
+                for (std::uint64_t k = 0; k < count; ++k)
+                    sum += samples[k * lanes + lane];
+                value_type mean = sum / static_cast<value_type>(count), square = 0.0;
+                for (std::uint64_t k = 0; k < count; ++k)
+                {
+                    value_type deviation = samples[k * lanes + lane] - mean;
+                    square += deviation * deviation;
+                }
+                sums[lane * blocks] = sum;
+                squares[lane * blocks] = square;
+            }
+        }
+    } // namespace math::calculus::details
+
+    // Monte Carlo estimate of E[payoff] and dE[payoff]/dparameters over path_count paths,
+    // path k draws from stream k of seed and blocks of paths are reduced in a fixed order,
+    // so the result is bitwise the same for every thread count
+    template <typename func_tp, typename value_type, std::size_t n>
+    details::_pathwise_estimate<value_type, n> pathwise_sensitivities(func_tp path,
+                                                                      const std::array<value_type, n> &parameters,
+                                                                      std::uint64_t path_count,
+                                                                      std::uint64_t seed,
+                                                                      size_type threads = 0)
+    {
+        static constexpr std::size_t lanes = n + 1;
+        if (path_count < 2)
+            throw std::runtime_error("path_count < 2 at math::calculus::pathwise_sensitivities");
+        std::uint64_t block_count = (path_count + details::_path_block - 1) / details::_path_block;
+        if (block_count > std::numeric_limits<size_type>::max() / lanes)
+            throw std::runtime_error("too many paths at math::calculus::pathwise_sensitivities");
+        size_type blocks = static_cast<size_type>(block_count);
+
+        std::array<details::_multi_dual_number<value_type, n>, n> seeded;
+        for (std::size_t i = 0; i < n; ++i)
+            seeded[i] = details::_multi_dual_number<value_type, n>{parameters[i], i};
+
+        // each thread owns a sample buffer and writes only the partials of its own blocks
+        std::vector<value_type> sums(lanes * blocks), squares(lanes * blocks);
+        auto block_moments = [&](size_type first, size_type last)
+        {
+            std::vector<value_type> samples(details::_path_block * lanes);
+            for (size_type b = first; b < last; ++b)
+            {
+                std::uint64_t begin = b * details::_path_block;
+                std::uint64_t end = std::min(begin + details::_path_block, path_count);
+                details::_pathwise_block(path, seeded, seed, begin, end, samples,
+                                         sums.data() + b, squares.data() + b, blocks);
+            }
+        };
+        utility::parallel_for(blocks, threads, block_moments);
+
+        // the squared deviations of all paths from the overall mean are the in-block ones
+        // plus path_count_b * (mean_b - mean)^2 per block
+        std::array<value_type, lanes> mean, error;
+        std::vector<value_type> shift(blocks);
+        value_type total = static_cast<value_type>(path_count);
+        for (std::size_t lane = 0; lane < lanes; ++lane)
+        {
+            value_type *lane_sums = sums.data() + lane * blocks;
+            for (size_type b = 0; b < blocks; ++b)
+            {
+                std::uint64_t begin = std::uint64_t{b} * details::_path_block;
+                value_type count = static_cast<value_type>(std::min(details::_path_block, path_count - begin));
+                shift[b] = lane_sums[b] / count;
+            }
+            mean[lane] = algebra::details::_pairwise_sum(lane_sums, blocks) / total;
+            for (size_type b = 0; b < blocks; ++b)
+            {
+                std::uint64_t begin = std::uint64_t{b} * details::_path_block;
+                value_type count = static_cast<value_type>(std::min(details::_path_block, path_count - begin));
+                value_type deviation = shift[b] - mean[lane];
+                shift[b] = count * deviation * deviation;
+            }
+            value_type square = algebra::details::_pairwise_sum(squares.data() + lane * blocks, blocks) +
+                                algebra::details::_pairwise_sum(shift.data(), blocks);
+            error[lane] = std::sqrt(square / (total - 1.0) / total);
+        }
+
+        details::_pathwise_estimate<value_type, n> estimate;
+        estimate.value = mean[0];
+        estimate.value_error = error[0];
+        std::copy(mean.begin() + 1, mean.end(), estimate.sensitivities.begin());
+        std::copy(error.begin() + 1, error.end(), estimate.sensitivity_errors.begin());
+        return estimate;
+    }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_FO_PATHWISE_HPP
@@ -0,0 +1,241 @@
+#ifndef MATH_CALCULUS_FO_SENSITIVITY_HPP
+#define MATH_CALCULUS_FO_SENSITIVITY_HPP
+
+#include "Config.hpp"
+
+#include "FOMultiDual.hpp"
+#include "Utility/Parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+
+// f(t, y, p) returns y' as std::array<number, n> for const std::array<number, n> &y and
+// const std::array<number, m> &p, where number is _multi_dual_number<value_type, lanes> and t a plain value;
+// the parameters are integrated lanes at a time, each group carrying the state and the tangents of its lanes
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace details
+    {
+        template <typename value_type>
+        struct _ode_options
+        {
+            // a step is accepted when the weighted RMS of its error estimate is at most 1,
+            // component i is weighted by absolute_tolerance + relative_tolerance * |y_i|
+            value_type relative_tolerance = 1e-8;
+            value_type absolute_tolerance = 1e-10;
+            // 0 starts with a hundredth of the interval
+            value_type initial_step = 0.0;
+            size_type max_steps = 100000;
+        };
+
+        template <typename value_type, std::size_t n, std::size_t m>
+        struct _ode_sensitivity
+        {
+            // y(t1) and dy_i(t1)/dp_j at sensitivity[i * m + j]
+            std::array<value_type, n> y;
+            std::array<value_type, n * m> sensitivity;
+            size_type steps;
+            size_type rejected_steps;
+        };
+
+        template <typename value_type, std::size_t lanes, std::size_t n>
+        using _lane_state = std::array<_multi_dual_number<value_type, lanes>, n>;
+
+        // y0 as constants and p with parameter first + l seeded on lane l
+        template <typename value_type, std::size_t lanes, std::size_t n, std::size_t m>
+        void _seed_group(const std::array<value_type, n> &y0, const std::array<value_type, m> &p, std::size_t first,
+                         _lane_state<value_type, lanes, n> &y, _lane_state<value_type, lanes, m> &dp) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                y[i] = _multi_dual_number<value_type, lanes>{y0[i]};
+            for (std::size_t j = 0; j < m; ++j)
+                dp[j] = (j >= first && j < first + lanes) ? _multi_dual_number<value_type, lanes>{p[j], j - first}
+                                                           : _multi_dual_number<value_type, lanes>{p[j]};
+        }
+
+        // out = y + h * sum a[s] * k[s], the stage input of an explicit Runge-Kutta step
+        template <typename value_type, std::size_t lanes, std::size_t n, std::size_t stages>
+        void _stage(_lane_state<value_type, lanes, n> &out, const _lane_state<value_type, lanes, n> &y, value_type h,
+                    const std::array<value_type, stages> &a,
+                    const std::array<const _lane_state<value_type, lanes, n> *, stages> &k) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                _multi_dual_number<value_type, lanes> sum = y[i];
+                for (std::size_t s = 0; s < stages; ++s)
+                    if (a[s] != 0.0)
+                        sum += (*k[s])[i] * (h * a[s]);
+                out[i] = sum;
+            }
+        }
+
+        template <typename value_type, std::size_t lanes, std::size_t n, std::size_t m>
+        void _store_group(const _lane_state<value_type, lanes, n> &y, std::size_t first,
+                          _ode_sensitivity<value_type, n, m> &result) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                for (std::size_t l = 0; l < lanes && first + l < m; ++l)
+                    result.sensitivity[i * m + first + l] = y[i].dual[l];
+            // every group runs the same primal, the first one reports it
+            if (first == 0)
+                for (std::size_t i = 0; i < n; ++i)
+                    result.y[i] = y[i].real;
+        }
+
+        // classical fourth order Runge-Kutta with steps equal steps for the group starting at first
+        template <std::size_t lanes, typename func_tp, typename value_type, std::size_t n, std::size_t m>
+        void _rk4_group(func_tp &f, value_type t0, value_type t1, size_type steps, const std::array<value_type, n> &y0,
+                        const std::array<value_type, m> &p, std::size_t first, _ode_sensitivity<value_type, n, m> &result)
+        {
+            _lane_state<value_type, lanes, n> y, stage, k1, k2, k3, k4;
+            _lane_state<value_type, lanes, m> dp;
+            _seed_group(y0, p, first, y, dp);
+            const auto &cp = dp;
+            value_type h = (t1 - t0) / steps;
+            for (size_type k = 0; k < steps; ++k)
+            {
+                value_type t = t0 + k * h;
+                k1 = f(t, static_cast<const _lane_state<value_type, lanes, n> &>(y), cp);
+                _stage<value_type, lanes, n, 1>(stage, y, h, {0.5}, {&k1});
+                k2 = f(t + 0.5 * h, static_cast<const _lane_state<value_type, lanes, n> &>(stage), cp);
+                _stage<value_type, lanes, n, 1>(stage, y, h, {0.5}, {&k2});
+                k3 = f(t + 0.5 * h, static_cast<const _lane_state<value_type, lanes, n> &>(stage), cp);
+                _stage<value_type, lanes, n, 1>(stage, y, h, {1.0}, {&k3});
+                k4 = f(t + h, static_cast<const _lane_state<value_type, lanes, n> &>(stage), cp);
+                _stage<value_type, lanes, n, 4>(y, y, h, {1.0 / 6.0, 1.0 / 3.0, 1.0 / 3.0, 1.0 / 6.0}, {&k1, &k2, &k3, &k4});
+            }
+            _store_group(y, first, result);
+        }
+
+        // Dormand-Prince 5(4) with the fifth order solution propagated and the first stage reused from the last;
+        // the error estimate reads only the primal, so every group takes the steps of the primal solve
+        template <std::size_t lanes, typename func_tp, typename value_type, std::size_t n, std::size_t m>
+        void _dopri5_group(func_tp &f, value_type t0, value_type t1, const std::array<value_type, n> &y0,
+                           const std::array<value_type, m> &p, const _ode_options<value_type> &options,
+                           std::size_t first, _ode_sensitivity<value_type, n, m> &result)
+        {
+            typedef _lane_state<value_type, lanes, n> state_type;
+            static constexpr value_type c2 = 1.0 / 5.0, c3 = 3.0 / 10.0, c4 = 4.0 / 5.0, c5 = 8.0 / 9.0;
+            static constexpr std::array<value_type, 7> e{71.0 / 57600.0, 0.0, -71.0 / 16695.0, 71.0 / 1920.0,
+                                                          -17253.0 / 339200.0, 22.0 / 525.0, -1.0 / 40.0};
+
+            state_type y, stage, y_new, k1, k2, k3, k4, k5, k6, k7;
+            _lane_state<value_type, lanes, m> dp;
+            _seed_group(y0, p, first, y, dp);
+            const auto &cp = dp;
+            auto rhs = [&](value_type t, const state_type &x) { return f(t, x, cp); };
+
+            value_type span = t1 - t0, t = t0;
+            value_type h = options.initial_step > 0.0 ? std::copysign(options.initial_step, span) : span / 100.0;
+            size_type steps = 0, rejected = 0;
+            k1 = rhs(t, y);
+            while ((t1 - t) * span > 0.0)
+            {
+                if (steps + rejected >= options.max_steps)
+                    throw std::runtime_error("too many steps at math::calculus::dopri5_sensitivities");
+                if ((t + h - t1) * span > 0.0)
+                    h = t1 - t;
+                if (std::abs(h) <= 16.0 * std::numeric_limits<value_type>::epsilon() * std::abs(t))
+                    throw std::runtime_error("step size underflow at math::calculus::dopri5_sensitivities");
+
+                _stage<value_type, lanes, n, 1>(stage, y, h, {1.0 / 5.0}, {&k1});
+                k2 = rhs(t + c2 * h, stage);
+                _stage<value_type, lanes, n, 2>(stage, y, h, {3.0 / 40.0, 9.0 / 40.0}, {&k1, &k2});
+                k3 = rhs(t + c3 * h, stage);
+                _stage<value_type, lanes, n, 3>(stage, y, h, {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0}, {&k1, &k2, &k3});
+                k4 = rhs(t + c4 * h, stage);
+                _stage<value_type, lanes, n, 4>(stage, y, h, {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0},
+                                                {&k1, &k2, &k3, &k4});
+                k5 = rhs(t + c5 * h, stage);
+                _stage<value_type, lanes, n, 5>(stage, y, h, {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0},
+                                                {&k1, &k2, &k3, &k4, &k5});
+                k6 = rhs(t + h, stage);
+                _stage<value_type, lanes, n, 6>(y_new, y, h, {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0},
+                                                {&k1, &k2, &k3, &k4, &k5, &k6});
+                k7 = rhs(t + h, y_new);
+
+                value_type error = 0.0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    value_type estimate = h * (e[0] * k1[i].real + e[2] * k3[i].real + e[3] * k4[i].real +
+                                               e[4] * k5[i].real + e[5] * k6[i].real + e[6] * k7[i].real);
+                    value_type scale = options.absolute_tolerance +
+                                       options.relative_tolerance * std::max(std::abs(y[i].real), std::abs(y_new[i].real));
+                    error += (estimate / scale) * (estimate / scale);
+                }
+                error = std::sqrt(error / static_cast<value_type>(n > 0 ? n : 1));
+
+                if (error <= 1.0)
+                {
+                    t += h;
+                    y = y_new;
+                    k1 = k7;
+                    ++steps;
+                }
+                else
+                    ++rejected;
+                value_type factor = error == 0.0 ? 5.0 : 0.9 * std::pow(error, value_type{-0.2});
+                h *= std::min(value_type{5.0}, std::max(value_type{0.2}, factor));
+            }
+
+            _store_group(y, first, result);
+            if (first == 0)
+            {
+                result.steps = steps;
+                result.rejected_steps = rejected;
+            }
+        }
+
+        template <std::size_t lanes, std::size_t m, typename group_tp>
+        void _parameter_groups(size_type threads, group_tp group)
+        {
+            static_assert(lanes > 0, "sensitivities need at least one lane");
+            size_type groups = static_cast<size_type>(m == 0 ? 1 : (m + lanes - 1) / lanes);
+            utility::parallel_for(groups, threads,
+                                  [&](size_type begin, size_type end)
+                                  {
+                                      for (size_type g = begin; g < end; ++g)
+                                          group(static_cast<std::size_t>(g) * lanes);
+                                  });
+        }
+    } // namespace math::calculus::details
+
+    // y(t1) and dy(t1)/dp for y' = f(t, y, p), y(t0) = y0, by steps classical Runge-Kutta steps;
+    // threads > 1 integrates the groups of lanes parameters concurrently, so f must then be safe to call concurrently
+    template <std::size_t lanes = 8, typename func_tp, typename value_type, std::size_t n, std::size_t m>
+    details::_ode_sensitivity<value_type, n, m> rk4_sensitivities(func_tp f, value_type t0, value_type t1, size_type steps,
+                                                                   const std::array<value_type, n> &y0,
+                                                                   const std::array<value_type, m> &p,
+                                                                   size_type threads = 1)
+    {
+        if (steps == 0)
+            throw std::runtime_error("steps = 0 at math::calculus::rk4_sensitivities");
+        details::_ode_sensitivity<value_type, n, m> result{};
+        details::_parameter_groups<lanes, m>(threads, [&](std::size_t first)
+                                             { details::_rk4_group<lanes>(f, t0, t1, steps, y0, p, first, result); });
+        result.steps = steps;
+        return result;
+    }
+
+    // the same by adaptive Dormand-Prince 5(4) steps
+    template <std::size_t lanes = 8, typename func_tp, typename value_type, std::size_t n, std::size_t m>
+    details::_ode_sensitivity<value_type, n, m> dopri5_sensitivities(func_tp f, value_type t0, value_type t1,
+                                                                      const std::array<value_type, n> &y0,
+                                                                      const std::array<value_type, m> &p,
+                                                                      const details::_ode_options<value_type> &options = {},
+                                                                      size_type threads = 1)
+    {
+        details::_ode_sensitivity<value_type, n, m> result{};
+        details::_parameter_groups<lanes, m>(threads, [&](std::size_t first)
+                                             { details::_dopri5_group<lanes>(f, t0, t1, y0, p, options, first, result); });
+        return result;
+    }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_FO_SENSITIVITY_HPP
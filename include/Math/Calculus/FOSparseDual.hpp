@@ -0,0 +1,843 @@
+#ifndef MATH_CALCULUS_FO_SPARSE_DUAL_HPP
+#define MATH_CALCULUS_FO_SPARSE_DUAL_HPP
+
+#include "Config.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace details
+    {
+        // overflow storage of sparse tangents, a block of size class c holds 2^c entries,
+        // blocks are carved from large chunks and recycled through per-thread free lists;
+        // an exiting thread hands its lists to a shared pool, so a number may be released
+        // on another thread than the one that grew it
+        template <typename value_type>
+        class _sparse_arena
+        {
+        public:
+            typedef std::uint32_t index_type;
+            static constexpr size_type min_class = 4;
+            static constexpr size_type class_count = 32;
+
+            static constexpr std::size_t block_bytes(size_type size_class) noexcept
+            {
+                return (std::size_t{1} << size_class) * (sizeof(value_type) + sizeof(index_type));
+            }
+
+            // smallest class holding count entries
+            static size_type size_class(size_type count) noexcept
+            {
+                size_type c = min_class;
+                while ((size_type{1} << c) < count)
+                    ++c;
+                return c;
+            }
+
+            static void *allocate(size_type size_class)
+            {
+                _pool &pool = _local();
+                _block *block = pool.free[size_class];
+                if (block == nullptr)
+                    block = _adopt(size_class);
+                if (block != nullptr)
+                {
+                    pool.free[size_class] = block->next;
+                    return block;
+                }
+
+                std::size_t bytes = block_bytes(size_class);
+                if (bytes > _chunk_bytes)
+                    return ::operator new(bytes);
+                if (pool.cursor == nullptr || static_cast<std::size_t>(pool.end - pool.cursor) < bytes)
+                {
+                    // the tail of the previous chunk is given up
+                    pool.cursor = static_cast<char *>(::operator new(_chunk_bytes));
+                    pool.end = pool.cursor + _chunk_bytes;
+                }
+                void *result = pool.cursor;
+                pool.cursor += bytes;
+                return result;
+            }
+
+            static void deallocate(void *pointer, size_type size_class) noexcept
+            {
+                _pool &pool = _local();
+                _block *block = static_cast<_block *>(pointer);
+                block->next = pool.free[size_class];
+                pool.free[size_class] = block;
+            }
+
+        private:
+            static constexpr std::size_t _chunk_bytes = std::size_t{1} << 16;
+
+            struct _block
+            {
+                _block *next;
+            };
+
+            struct _shared
+            {
+                std::mutex mutex;
+                std::atomic<size_type> blocks{0};
+                std::array<_block *, class_count> free{};
+            };
+
+            // chunks are never returned to the system, memory stays at the high-water mark
+            struct _pool
+            {
+                std::array<_block *, class_count> free{};
+                char *cursor = nullptr;
+                char *end = nullptr;
+
+                ~_pool()
+                {
+                    _shared &shared = _global();
+                    std::lock_guard<std::mutex> lock{shared.mutex};
+                    for (size_type c = 0; c < class_count; ++c)
+                        while (free[c] != nullptr)
+                        {
+                            _block *block = free[c];
+                            free[c] = block->next;
+                            block->next = shared.free[c];
+                            shared.free[c] = block;
+                            shared.blocks.fetch_add(1, std::memory_order_relaxed);
+                        }
+                }
+            };
+
+            static _pool &_local()
+            {
+                thread_local _pool pool;
+                return pool;
+            }
+
+            static _shared &_global()
+            {
+                static _shared shared;
+                return shared;
+            }
+
+            // takes the whole shared list of a class, the lock is skipped while nothing was handed over
+            static _block *_adopt(size_type size_class)
+            {
+                _shared &shared = _global();
+                if (shared.blocks.load(std::memory_order_relaxed) == 0)
+                    return nullptr;
+                std::lock_guard<std::mutex> lock{shared.mutex};
+                _block *list = shared.free[size_class];
+                shared.free[size_class] = nullptr;
+                for (_block *block = list; block != nullptr; block = block->next)
+                    shared.blocks.fetch_sub(1, std::memory_order_relaxed);
+                return list;
+            }
+        };
+
+        // dual number whose tangent is a sparse vector sorted by input index,
+        // up to inline_capacity nonzeros live in the object, more spill to _sparse_arena
+        template <typename value_type = math::real, size_type inline_capacity = 8>
+        class _sparse_dual_number
+        {
+            static_assert(std::is_floating_point<value_type>::value);
+            static_assert(inline_capacity > 0);
+            typedef _sparse_dual_number<value_type, inline_capacity> same_type;
+            typedef _sparse_arena<value_type> arena_type;
+
+        public:
+            typedef std::uint32_t index_type;
+
+            value_type real = 0.0;
+
+            _sparse_dual_number() = default;
+
+            // constant
+            _sparse_dual_number(value_type value) noexcept : real{value} {}
+
+            // input number index, its tangent is seed * e_index
+            _sparse_dual_number(value_type value, index_type index, value_type seed = 1.0) noexcept
+                : real{value}, _size{1}
+            {
+                _inline_index[0] = index;
+                _inline_tangent[0] = seed;
+            }
+
+            _sparse_dual_number(const same_type &rhs) : real{rhs.real}
+            {
+                _reserve(rhs._size);
+                _assign_tangent(rhs);
+            }
+
+            _sparse_dual_number(same_type &&rhs) noexcept : real{rhs.real}
+            {
+                _steal(rhs);
+            }
+
+            same_type &operator=(const same_type &rhs)
+            {
+                if (&rhs == this)
+                    return *this;
+                real = rhs.real;
+                if (rhs._size > _capacity())
+                {
+                    _release();
+                    _reserve(rhs._size);
+                }
+                _assign_tangent(rhs);
+                return *this;
+            }
+
+            same_type &operator=(same_type &&rhs) noexcept
+            {
+                if (&rhs == this)
+                    return *this;
+                real = rhs.real;
+                _release();
+                _steal(rhs);
+                return *this;
+            }
+
+            ~_sparse_dual_number() { _release(); }
+
+            size_type nonzeros() const noexcept { return _size; }
+            const index_type *indices() const noexcept { return _index_data(); }
+            const value_type *tangents() const noexcept { return _tangent_data(); }
+
+            // partial derivative with respect to input index, 0 when it does not depend on it
+            value_type derivative(index_type index) const noexcept
+            {
+                const index_type *first = _index_data();
+                const index_type *it = std::lower_bound(first, first + _size, index);
+                return (it != first + _size && *it == index) ? _tangent_data()[it - first] : value_type{};
+            }
+
+            // arithmetic group
+
+            // accumulating terms over increasing inputs appends in place instead of merging
+            same_type &operator+=(const same_type &rhs)
+            {
+                if (_appendable(rhs))
+                    _append(rhs, 1.0);
+                else
+                    *this = _combine(real, *this, 1.0, rhs, 1.0);
+                real += rhs.real;
+                return *this;
+            }
+
+            same_type &operator+=(value_type scalar) noexcept
+            {
+                real += scalar;
+                return *this;
+            }
+
+            same_type &operator-=(const same_type &rhs)
+            {
+                if (_appendable(rhs))
+                    _append(rhs, -1.0);
+                else
+                    *this = _combine(real, *this, 1.0, rhs, -1.0);
+                real -= rhs.real;
+                return *this;
+            }
+
+            same_type &operator-=(value_type scalar) noexcept
+            {
+                real -= scalar;
+                return *this;
+            }
+
+            same_type &operator*=(const same_type &rhs)
+            {
+                *this = _combine(real * rhs.real, *this, rhs.real, rhs, real);
+                return *this;
+            }
+
+            same_type &operator*=(value_type scalar) noexcept
+            {
+                real *= scalar;
+                _scale(scalar);
+                return *this;
+            }
+
+            same_type &operator/=(const same_type &rhs)
+            {
+                value_type inv = 1.0 / rhs.real;
+                *this = _combine(real * inv, *this, inv, rhs, -real * inv * inv);
+                return *this;
+            }
+
+            same_type &operator/=(value_type scalar) noexcept
+            {
+                real /= scalar;
+                _scale(1.0 / scalar);
+                return *this;
+            }
+
+            same_type operator-() const
+            {
+                return _chain(-real, *this, -1.0);
+            }
+
+            friend same_type operator+(const same_type &lhs, const same_type &rhs)
+            {
+                return _combine(lhs.real + rhs.real, lhs, 1.0, rhs, 1.0);
+            }
+
+            friend same_type operator+(same_type lhs, value_type scalar) noexcept
+            {
+                lhs += scalar;
+                return lhs;
+            }
+
+            friend same_type operator+(value_type scalar, same_type rhs) noexcept
+            {
+                rhs += scalar;
+                return rhs;
+            }
+
+            friend same_type operator-(const same_type &lhs, const same_type &rhs)
+            {
+                return _combine(lhs.real - rhs.real, lhs, 1.0, rhs, -1.0);
+            }
+
+            friend same_type operator-(same_type lhs, value_type scalar) noexcept
+            {
+                lhs -= scalar;
+                return lhs;
+            }
+
+            friend same_type operator-(value_type scalar, const same_type &rhs)
+            {
+                return _chain(scalar - rhs.real, rhs, -1.0);
+            }
+
+            friend same_type operator*(const same_type &lhs, const same_type &rhs)
+            {
+                return _combine(lhs.real * rhs.real, lhs, rhs.real, rhs, lhs.real);
+            }
+
+            friend same_type operator*(same_type lhs, value_type scalar) noexcept
+            {
+                lhs *= scalar;
+                return lhs;
+            }
+
+            friend same_type operator*(value_type scalar, same_type rhs) noexcept
+            {
+                rhs *= scalar;
+                return rhs;
+            }
+
+            friend same_type operator/(const same_type &lhs, const same_type &rhs)
+            {
+                value_type inv = 1.0 / rhs.real;
+                return _combine(lhs.real * inv, lhs, inv, rhs, -lhs.real * inv * inv);
+            }
+
+            friend same_type operator/(same_type lhs, value_type scalar) noexcept
+            {
+                lhs /= scalar;
+                return lhs;
+            }
+
+            friend same_type operator/(value_type scalar, const same_type &rhs)
+            {
+                value_type inv = 1.0 / rhs.real;
+                return _chain(scalar * inv, rhs, -scalar * inv * inv);
+            }
+
+            // x.real != 0
+            friend same_type abs(const same_type &x)
+            {
+                if (x.real == 0.0)
+                    throw std::runtime_error("x.real = 0 at math::abs<_sparse_dual_number>");
+                return _chain(std::abs(x.real), x, x.real > 0.0 ? 1.0 : -1.0);
+            }
+
+            // power group
+
+            friend same_type sq(const same_type &x)
+            {
+                return _chain(x.real * x.real, x, 2.0 * x.real);
+            }
+
+            friend same_type cb(const same_type &x)
+            {
+                return _chain(x.real * x.real * x.real, x, 3.0 * x.real * x.real);
+            }
+
+            friend same_type sqrt(const same_type &x)
+            {
+                if (x.real <= 0.0)
+                    throw std::runtime_error("x.real <= 0 at math::sqrt<_sparse_dual_number>");
+                value_type sqrt_xr = std::sqrt(x.real);
+                return _chain(sqrt_xr, x, 0.5 / sqrt_xr);
+            }
+
+            friend same_type cbrt(const same_type &x)
+            {
+                if (x.real == 0.0)
+                    throw std::runtime_error("x.real = 0 at math::cbrt<_sparse_dual_number>");
+                value_type cbrt_xr = std::cbrt(x.real);
+                return _chain(cbrt_xr, x, 1.0 / (3.0 * cbrt_xr * cbrt_xr));
+            }
+
+            // x.real != 0 || y.real != 0
+            friend same_type hypot(const same_type &x, const same_type &y)
+            {
+                value_type hypot_xy = std::hypot(x.real, y.real);
+                if (hypot_xy == 0.0)
+                    throw std::runtime_error("x.real = y.real = 0 at math::hypot<_sparse_dual_number>");
+                return _combine(hypot_xy, x, x.real / hypot_xy, y, y.real / hypot_xy);
+            }
+
+            friend same_type pow(const same_type &x, value_type p)
+            {
+                if (x.real == 0.0)
+                    throw std::runtime_error("x.real = 0 at math::pow_x_n<_sparse_dual_number>");
+                value_type pow_xr = std::pow(x.real, p);
+                return _chain(pow_xr, x, p * pow_xr / x.real);
+            }
+
+            // exponential and logarithmic group
+
+            // x^x
+            friend same_type pow(const same_type &x)
+            {
+                if (x.real <= 0.0)
+                    throw std::runtime_error("x.real <= 0 at math::pow_x_x<_sparse_dual_number>");
+                value_type xr_pow_xr = std::pow(x.real, x.real);
+                return _chain(xr_pow_xr, x, xr_pow_xr * (1.0 + std::log(x.real)));
+            }
+
+            // the log(f) term only enters when g carries a tangent, so negative bases work for constant g
+            friend same_type pow(const same_type &f, const same_type &g)
+            {
+                value_type pow_fg = std::pow(f.real, g.real);
+                value_type df = f.real != 0.0 ? g.real * pow_fg / f.real
+                                              : g.real * std::pow(f.real, g.real - 1.0);
+                value_type dg{};
+                if (g._size != 0)
+                {
+                    if (f.real < 0.0)
+                        throw std::runtime_error("f.real < 0 at math::pow_f_g<_sparse_dual_number>");
+                    if (f.real > 0.0)
+                        dg = pow_fg * std::log(f.real);
+                }
+                return _combine(pow_fg, f, df, g, dg);
+            }
+
+            friend same_type exp(const same_type &x)
+            {
+                value_type exp_xr = std::exp(x.real);
+                return _chain(exp_xr, x, exp_xr);
+            }
+
+            friend same_type exp_n(value_type n, const same_type &x)
+            {
+                if (x.real <= 0.0)
+                    throw std::runtime_error("x.real <= 0 at math::exp_n_x<_sparse_dual_number>");
+                value_type exp_n_xr = std::pow(n, x.real);
+                return _chain(exp_n_xr, x, std::log(n) * exp_n_xr);
+            }
+
+            friend same_type log(const same_type &x)
+            {
+                if (x.real <= 0.0)
+                    throw std::runtime_error("x.real <= 0 at math::ln<_sparse_dual_number>");
+                return _chain(std::log(x.real), x, 1.0 / x.real);
+            }
+
+            friend same_type ln(const same_type &x)
+            {
+                return log(x);
+            }
+
+            friend same_type log_n(value_type n, const same_type &x)
+            {
+                if (n <= 0.0 || n == 1.0)
+                    throw std::runtime_error("n <= 0 || n = 1 at math::log_n_x<_sparse_dual_number>");
+                if (x.real <= 0.0)
+                    throw std::runtime_error("x.real <= 0 at math::log_n_x<_sparse_dual_number>");
+                value_type ln_n = std::log(n);
+                return _chain(std::log(x.real) / ln_n, x, 1.0 / (x.real * ln_n));
+            }
+
+            friend same_type log_x_n(const same_type &x, value_type n)
+            {
+                if (n <= 0.0)
+                    throw std::runtime_error("n <= 0 at math::log_x_n<_sparse_dual_number>");
+                if (x.real <= 0.0 || x.real == 1.0)
+                    throw std::runtime_error("x.real <= 0 || x.real = 1 at math::log_x_n<_sparse_dual_number>");
+                value_type ln_n = std::log(n);
+                value_type ln_x = std::log(x.real);
+                return _chain(ln_n / ln_x, x, -ln_n / (x.real * ln_x * ln_x));
+            }
+
+            // trigonometric group
+
+            friend same_type sin(const same_type &x)
+            {
+                return _chain(std::sin(x.real), x, std::cos(x.real));
+            }
+
+            friend same_type cos(const same_type &x)
+            {
+                return _chain(std::cos(x.real), x, -std::sin(x.real));
+            }
+
+            friend same_type tan(const same_type &x)
+            {
+                value_type tan_xr = std::tan(x.real);
+                return _chain(tan_xr, x, 1.0 + tan_xr * tan_xr);
+            }
+
+            friend same_type cot(const same_type &x)
+            {
+                value_type cot_xr = 1.0 / std::tan(x.real);
+                return _chain(cot_xr, x, -1.0 - cot_xr * cot_xr);
+            }
+
+            friend same_type sec(const same_type &x)
+            {
+                value_type cos_xr = std::cos(x.real);
+                return _chain(1.0 / cos_xr, x, std::tan(x.real) / cos_xr);
+            }
+
+            friend same_type csc(const same_type &x)
+            {
+                value_type sin_xr = std::sin(x.real);
+                return _chain(1.0 / sin_xr, x, -1.0 / (sin_xr * std::tan(x.real)));
+            }
+
+            friend same_type asin(const same_type &x)
+            {
+                return _chain(std::asin(x.real), x, 1.0 / std::sqrt(1.0 - x.real * x.real));
+            }
+
+            friend same_type acos(const same_type &x)
+            {
+                return _chain(std::acos(x.real), x, -1.0 / std::sqrt(1.0 - x.real * x.real));
+            }
+
+            friend same_type atan(const same_type &x)
+            {
+                return _chain(std::atan(x.real), x, 1.0 / (1.0 + x.real * x.real));
+            }
+
+            friend same_type acot(const same_type &x)
+            {
+                return _chain(std::atan(1.0 / x.real), x, -1.0 / (1.0 + x.real * x.real));
+            }
+
+            friend same_type asec(const same_type &x)
+            {
+                return _chain(std::acos(1.0 / x.real), x, 1.0 / (std::abs(x.real) * std::sqrt(x.real * x.real - 1.0)));
+            }
+
+            friend same_type acsc(const same_type &x)
+            {
+                return _chain(std::asin(1.0 / x.real), x, -1.0 / (std::abs(x.real) * std::sqrt(x.real * x.real - 1.0)));
+            }
+
+            // angle of (x, y), x.real != 0 || y.real != 0
+            friend same_type atan2(const same_type &y, const same_type &x)
+            {
+                value_type r_sq = x.real * x.real + y.real * y.real;
+                if (r_sq == 0.0)
+                    throw std::runtime_error("x.real = y.real = 0 at math::atan2<_sparse_dual_number>");
+                return _combine(std::atan2(y.real, x.real), y, x.real / r_sq, x, -y.real / r_sq);
+            }
+
+            // hyperbolic group
+
+            friend same_type sinh(const same_type &x)
+            {
+                return _chain(std::sinh(x.real), x, std::cosh(x.real));
+            }
+
+            friend same_type cosh(const same_type &x)
+            {
+                return _chain(std::cosh(x.real), x, std::sinh(x.real));
+            }
+
+            friend same_type tanh(const same_type &x)
+            {
+                value_type tanh_xr = std::tanh(x.real);
+                return _chain(tanh_xr, x, 1.0 - tanh_xr * tanh_xr);
+            }
+
+            friend same_type coth(const same_type &x)
+            {
+                value_type coth_xr = 1.0 / std::tanh(x.real);
+                return _chain(coth_xr, x, 1.0 - coth_xr * coth_xr);
+            }
+
+            friend same_type sech(const same_type &x)
+            {
+                value_type sech_xr = 1.0 / std::cosh(x.real);
+                return _chain(sech_xr, x, -sech_xr * std::tanh(x.real));
+            }
+
+            friend same_type csch(const same_type &x)
+            {
+                value_type csch_xr = 1.0 / std::sinh(x.real);
+                return _chain(csch_xr, x, -csch_xr / std::tanh(x.real));
+            }
+
+            friend same_type asinh(const same_type &x)
+            {
+                return _chain(std::asinh(x.real), x, 1.0 / std::sqrt(1.0 + x.real * x.real));
+            }
+
+            friend same_type acosh(const same_type &x)
+            {
+                return _chain(std::acosh(x.real), x, 1.0 / std::sqrt(x.real * x.real - 1.0));
+            }
+
+            friend same_type atanh(const same_type &x)
+            {
+                return _chain(std::atanh(x.real), x, 1.0 / (1.0 - x.real * x.real));
+            }
+
+            friend same_type acoth(const same_type &x)
+            {
+                return _chain(std::atanh(1.0 / x.real), x, 1.0 / (1.0 - x.real * x.real));
+            }
+
+            friend same_type asech(const same_type &x)
+            {
+                return _chain(std::acosh(1.0 / x.real), x, -1.0 / (x.real * std::sqrt(1.0 - x.real * x.real)));
+            }
+
+            friend same_type acsch(const same_type &x)
+            {
+                return _chain(std::asinh(1.0 / x.real), x, -1.0 / (std::abs(x.real) * std::sqrt(1.0 + x.real * x.real)));
+            }
+
+            // miscellaneous group
+
+            friend same_type fma(const same_type &x, const same_type &y, const same_type &z)
+            {
+                same_type xy = _combine(value_type{}, x, y.real, y, x.real);
+                return _combine(std::fma(x.real, y.real, z.real), xy, 1.0, z, 1.0);
+            }
+
+            // ties take the tangent of x, a NaN operand yields the other one as in std::fmin
+            friend same_type fmin(const same_type &x, const same_type &y)
+            {
+                return (y.real < x.real || std::isnan(x.real)) ? y : x;
+            }
+
+            friend same_type fmax(const same_type &x, const same_type &y)
+            {
+                return (y.real > x.real || std::isnan(x.real)) ? y : x;
+            }
+
+            friend std::ostream &operator<<(std::ostream &os, const same_type &x)
+            {
+                os << "(" << x.real << ", {";
+                for (size_type i = 0; i < x._size; ++i)
+                    os << (i == 0 ? "" : ", ") << x._index_data()[i] << ": " << x._tangent_data()[i];
+                return os << "})";
+            }
+
+        private:
+            index_type *_index_data() noexcept
+            {
+                return _block == nullptr ? _inline_index : reinterpret_cast<index_type *>(_heap_tangent() + _capacity());
+            }
+
+            const index_type *_index_data() const noexcept
+            {
+                return const_cast<same_type *>(this)->_index_data();
+            }
+
+            value_type *_tangent_data() noexcept
+            {
+                return _block == nullptr ? _inline_tangent : _heap_tangent();
+            }
+
+            const value_type *_tangent_data() const noexcept
+            {
+                return const_cast<same_type *>(this)->_tangent_data();
+            }
+
+            // values first, so both planes of a block stay aligned
+            value_type *_heap_tangent() const noexcept { return static_cast<value_type *>(_block); }
+
+            size_type _capacity() const noexcept
+            {
+                return _block == nullptr ? inline_capacity : size_type{1} << _size_class;
+            }
+
+            // room for count entries, only called on an empty inline number
+            void _reserve(size_type count)
+            {
+                if (count <= inline_capacity)
+                    return;
+                _size_class = arena_type::size_class(count);
+                _block = arena_type::allocate(_size_class);
+            }
+
+            void _release() noexcept
+            {
+                if (_block != nullptr)
+                    arena_type::deallocate(_block, _size_class);
+                _block = nullptr;
+                _size = 0;
+            }
+
+            void _steal(same_type &rhs) noexcept
+            {
+                _size = rhs._size;
+                if (rhs._block != nullptr)
+                {
+                    _block = rhs._block;
+                    _size_class = rhs._size_class;
+                    rhs._block = nullptr;
+                }
+                else
+                {
+                    std::copy_n(rhs._inline_index, rhs._size, _inline_index);
+                    std::copy_n(rhs._inline_tangent, rhs._size, _inline_tangent);
+                }
+                rhs._size = 0;
+            }
+
+            void _assign_tangent(const same_type &rhs) noexcept
+            {
+                _size = rhs._size;
+                std::copy_n(rhs._index_data(), rhs._size, _index_data());
+                std::copy_n(rhs._tangent_data(), rhs._size, _tangent_data());
+            }
+
+            // every index of rhs lies past the last one of *this, never true for rhs = *this unless both are empty
+            bool _appendable(const same_type &rhs) const noexcept
+            {
+                return _size == 0 || rhs._size == 0 || _index_data()[_size - 1] < rhs._index_data()[0];
+            }
+
+            // the block at least doubles when it runs out, so a long accumulation stays linear
+            void _append(const same_type &rhs, value_type scale)
+            {
+                size_type count = _size + rhs._size;
+                if (count > _capacity())
+                {
+                    same_type grown{real};
+                    grown._reserve(std::max(count, 2 * _capacity()));
+                    grown._assign_tangent(*this);
+                    *this = std::move(grown);
+                }
+                std::copy_n(rhs._index_data(), rhs._size, _index_data() + _size);
+                const value_type *rt = rhs._tangent_data();
+                value_type *tangent = _tangent_data() + _size;
+                for (size_type i = 0; i < rhs._size; ++i)
+                    tangent[i] = scale * rt[i];
+                _size = count;
+            }
+
+            void _scale(value_type scale) noexcept
+            {
+                value_type *tangent = _tangent_data();
+                for (size_type i = 0; i < _size; ++i)
+                    tangent[i] *= scale;
+            }
+
+            // result of a unary function, its tangent is scale * x'
+            static same_type _chain(value_type value, const same_type &x, value_type scale)
+            {
+                same_type result{value};
+                result._reserve(x._size);
+                result._size = x._size;
+                std::copy_n(x._index_data(), x._size, result._index_data());
+                const value_type *xt = x._tangent_data();
+                value_type *rt = result._tangent_data();
+                for (size_type i = 0; i < x._size; ++i)
+                    rt[i] = scale * xt[i];
+                return result;
+            }
+
+            // result of a binary function, its tangent is a_scale * a' + b_scale * b',
+            // the index lists are merged in one pass
+            static same_type _combine(value_type value, const same_type &a, value_type a_scale,
+                                      const same_type &b, value_type b_scale)
+            {
+                same_type result{value};
+                result._reserve(a._size + b._size);
+                const index_type *ai = a._index_data(), *bi = b._index_data();
+                const value_type *at = a._tangent_data(), *bt = b._tangent_data();
+                index_type *ri = result._index_data();
+                value_type *rt = result._tangent_data();
+
+                size_type i = 0, j = 0, k = 0;
+                while (i < a._size && j < b._size)
+                {
+                    if (ai[i] < bi[j])
+                    {
+                        ri[k] = ai[i];
+                        rt[k++] = a_scale * at[i++];
+                    }
+                    else if (bi[j] < ai[i])
+                    {
+                        ri[k] = bi[j];
+                        rt[k++] = b_scale * bt[j++];
+                    }
+                    else
+                    {
+                        ri[k] = ai[i];
+                        rt[k++] = a_scale * at[i++] + b_scale * bt[j++];
+                    }
+                }
+                for (; i < a._size; ++i, ++k)
+                {
+                    ri[k] = ai[i];
+                    rt[k] = a_scale * at[i];
+                }
+                for (; j < b._size; ++j, ++k)
+                {
+                    ri[k] = bi[j];
+                    rt[k] = b_scale * bt[j];
+                }
+                result._size = k;
+                return result;
+            }
+
+            size_type _size = 0;
+            size_type _size_class = 0;
+            void *_block = nullptr;
+            index_type _inline_index[inline_capacity];
+            value_type _inline_tangent[inline_capacity];
+        };
+    } // namespace math::calculus::details
+
+    // f(x) and its whole gradient in one sweep, f takes
+    // const std::vector<_sparse_dual_number<value_type, inline_capacity>> & and returns one number,
+    // the work is proportional to the nonzeros of the intermediate tangents rather than to x.size()
+    template <typename value_type = math::real, size_type inline_capacity = 8, typename func_tp>
+    details::_sparse_dual_number<value_type, inline_capacity> sparse_gradient(func_tp f, const std::vector<value_type> &x)
+    {
+        typedef details::_sparse_dual_number<value_type, inline_capacity> number_type;
+        std::vector<number_type> inputs;
+        inputs.reserve(x.size());
+        for (std::size_t i = 0; i < x.size(); ++i)
+            inputs.emplace_back(x[i], static_cast<typename number_type::index_type>(i));
+        return f(static_cast<const std::vector<number_type> &>(inputs));
+    }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_FO_SPARSE_DUAL_HPP
@@ -3,10 +3,13 @@
 
 #include "Config.hpp"
 
+#include "Utility/ScalarTraits.hpp"
+
 #include <vector>
 #include <array>
 #include <algorithm>
 #include <cmath>
+#include <stdexcept>
 #include <type_traits>
 
 namespace math
@@ -19,7 +22,7 @@ namespace math
         template <typename value_type = math::real, size_type highest_order = 1>
         class _high_order_dual_number
         {
-            static_assert(std::is_floating_point<value_type>::value);
+            static_assert(utility::scalar_traits<value_type>::is_scalar, "_high_order_dual_number needs a scalar value type");
             typedef std::array<value_type, highest_order> vl_type;
             typedef _high_order_dual_number<value_type, highest_order> same_type;
 
@@ -28,111 +31,269 @@ namespace math
             explicit _high_order_dual_number(value_type value) : _value_list{}
             {
                 _value_list[0] = value;
-                _value_list[1] = 1.0;
+                if (highest_order > 1)
+                    _value_list[1] = 1.0;
             }
 
             value_type derivative(size_type order) const noexcept
             {
-                size_type fact = 1.0;
-                for (size_type i = 2.0; i <= order; ++i)
+                value_type fact = 1.0;
+                for (size_type i = 2; i <= order; ++i)
                     fact *= i;
                 return fact * _value_list[order];
             }
 
-            same_type operator+(const same_type &rhs) const noexcept
+            // compound assignment works on the coefficients in place,
+            // the binary operators below take their left operand by value and reuse it
+
+            same_type &operator+=(const same_type &rhs) noexcept
             {
-                same_type result{};
+                for (size_type i = 0; i < highest_order; ++i)
+                    _value_list[i] += rhs._value_list[i];
+                return *this;
+            }
 
-                // size_type index = 0;
-                // std::for_each(result._value_list.begin(), result._value_list.end(),
-                //               [&](value_type &n)
-                //               {n=this->_value_list[index]+rhs._value_list[index];++index; });
+            same_type &operator+=(value_type scalar) noexcept
+            {
+                _value_list[0] += scalar;
+                return *this;
+            }
 
-                result._value_list[0] = _value_list[0] + rhs._value_list[0];
-                for (size_type i = 1; i < highest_order; ++i)
-                    result._value_list[i] = _value_list[i] + rhs._value_list[i];
+            same_type &operator-=(const same_type &rhs) noexcept
+            {
+                for (size_type i = 0; i < highest_order; ++i)
+                    _value_list[i] -= rhs._value_list[i];
+                return *this;
+            }
+
+            same_type &operator-=(value_type scalar) noexcept
+            {
+                _value_list[0] -= scalar;
+                return *this;
+            }
+
+            // zi only reads xj, yj with j <= i, so going from the top down needs no copy,
+            // rhs may be *this
+            same_type &operator*=(const same_type &rhs) noexcept
+            {
+                for (size_type i = highest_order; i-- > 0;)
+                {
+                    value_type temp = 0.0;
+                    for (size_type j = 0; j <= i; ++j)
+                        temp += _value_list[j] * rhs._value_list[i - j];
+                    _value_list[i] = temp;
+                }
+                return *this;
+            }
+
+            same_type &operator*=(value_type scalar) noexcept
+            {
+                for (size_type i = 0; i < highest_order; ++i)
+                    _value_list[i] *= scalar;
+                return *this;
+            }
+
+            // zi must be calculated sequetially, zi overwrites xi once it is no longer needed
+            same_type &operator/=(const same_type &rhs) noexcept
+            {
+                if (&rhs == this)
+                {
+                    _value_list.fill(0.0);
+                    _value_list[0] = 1.0;
+                    return *this;
+                }
+                for (size_type i = 0; i < highest_order; ++i)
+                {
+                    value_type temp = _value_list[i];
+                    for (size_type j = 1; j <= i; ++j)
+                        temp -= rhs._value_list[j] * _value_list[i - j];
+                    _value_list[i] = temp / rhs._value_list[0];
+                }
+                return *this;
+            }
+
+            same_type &operator/=(value_type scalar) noexcept
+            {
+                for (size_type i = 0; i < highest_order; ++i)
+                    _value_list[i] /= scalar;
+                return *this;
+            }
+
+            same_type operator-() const noexcept
+            {
+                same_type result;
+                for (size_type i = 0; i < highest_order; ++i)
+                    result._value_list[i] = -_value_list[i];
                 return result;
             }
 
-            same_type operator-(const same_type &rhs) const noexcept
+            friend same_type operator+(same_type lhs, const same_type &rhs) noexcept { lhs += rhs; return lhs; }
+            friend same_type operator+(same_type lhs, value_type scalar) noexcept { lhs += scalar; return lhs; }
+            friend same_type operator+(value_type scalar, same_type rhs) noexcept { rhs += scalar; return rhs; }
+
+            friend same_type operator-(same_type lhs, const same_type &rhs) noexcept { lhs -= rhs; return lhs; }
+            friend same_type operator-(same_type lhs, value_type scalar) noexcept { lhs -= scalar; return lhs; }
+            friend same_type operator-(value_type scalar, same_type rhs) noexcept
             {
-                same_type result{};
-                result._value_list[0] = _value_list[0] - rhs._value_list[0];
+                for (size_type i = 0; i < highest_order; ++i)
+                    rhs._value_list[i] = -rhs._value_list[i];
+                rhs += scalar;
+                return rhs;
+            }
+
+            friend same_type operator*(same_type lhs, const same_type &rhs) noexcept { lhs *= rhs; return lhs; }
+            friend same_type operator*(same_type lhs, value_type scalar) noexcept { lhs *= scalar; return lhs; }
+            friend same_type operator*(value_type scalar, same_type rhs) noexcept { rhs *= scalar; return rhs; }
+
+            friend same_type operator/(same_type lhs, const same_type &rhs) noexcept { lhs /= rhs; return lhs; }
+            friend same_type operator/(same_type lhs, value_type scalar) noexcept { lhs /= scalar; return lhs; }
+
+            // reciprocal series scaled by scalar
+            friend same_type operator/(value_type scalar, const same_type &rhs) noexcept
+            {
+                same_type result;
+                result._value_list[0] = scalar / rhs._value_list[0];
                 for (size_type i = 1; i < highest_order; ++i)
-                    result._value_list[i] = _value_list[i] - rhs._value_list[i];
+                {
+                    value_type temp = 0.0;
+                    for (size_type j = 1; j <= i; ++j)
+                        temp += rhs._value_list[j] * result._value_list[i - j];
+                    result._value_list[i] = -temp / rhs._value_list[0];
+                }
                 return result;
             }
 
-            same_type operator*(const same_type &rhs) const noexcept
+            // y += a * x without a temporary, y may alias a or x
+            friend void axpy(value_type a, const same_type &x, same_type &y) noexcept
             {
-                same_type result{};
-                result._value_list[0] = _value_list[0] * rhs._value_list[0];
-                for (size_type i = 1; i < highest_order; ++i)
+                for (size_type i = 0; i < highest_order; ++i)
+                    y._value_list[i] += a * x._value_list[i];
+            }
+
+            friend void axpy(const same_type &a, const same_type &x, same_type &y) noexcept
+            {
+                for (size_type i = highest_order; i-- > 0;)
+                {
+                    value_type temp = 0.0;
                     for (size_type j = 0; j <= i; ++j)
-                        result._value_list[i] += _value_list[j] * rhs._value_list[i - j];
-                return result;
+                        temp += a._value_list[j] * x._value_list[i - j];
+                    y._value_list[i] += temp;
+                }
             }
 
-            same_type operator*(value_type scalar) const noexcept
+            // power group
+
+            friend same_type sqrt(const same_type &x)
             {
+                if (x._value_list[0] <= 0.0)
+                    throw std::runtime_error("x <= 0 at math::sqrt<_high_order_dual_number>");
                 same_type result{};
-                result._value_list[0] = scalar * _value_list[0];
+                result._value_list[0] = sqrt(x._value_list[0]);
                 for (size_type i = 1; i < highest_order; ++i)
-                    result._value_list[i] = _value_list[i] * scalar;
+                {
+                    value_type temp = x._value_list[i];
+                    for (size_type j = 1; j < i; ++j)
+                        temp -= result._value_list[j] * result._value_list[i - j];
+                    result._value_list[i] = temp / (2.0 * result._value_list[0]);
+                }
                 return result;
             }
 
-            friend same_type operator*(value_type scalar, const same_type &rhs) noexcept
+            // x != 0 unless p is a natural number, negative x is fine for integral p
+            friend same_type pow(const same_type &x, value_type p)
             {
+                if (x._value_list[0] == 0.0)
+                {
+                    if (p < 0.0 || p != floor(p))
+                        throw std::runtime_error("x = 0 at math::pow_x_n<_high_order_dual_number>");
+                    return _repeated_squaring(x, static_cast<unsigned long>(static_cast<double>(p)));
+                }
                 same_type result{};
-                result._value_list[0] = scalar * rhs._value_list[0];
+                result._value_list[0] = pow(x._value_list[0], p);
                 for (size_type i = 1; i < highest_order; ++i)
-                    result._value_list[i] = rhs._value_list[i] * scalar;
+                {
+                    value_type temp = 0.0;
+                    for (size_type j = 1; j <= i; ++j)
+                        temp += ((p + 1.0) * j - i) * x._value_list[j] * result._value_list[i - j];
+                    result._value_list[i] = temp / (i * x._value_list[0]);
+                }
                 return result;
             }
 
-            // zi must be calculated sequetially
-            same_type operator/(const same_type &rhs) const noexcept
+            // f^g = exp(g * log(f)) for f > 0, a constant g falls back to pow(f, p)
+            friend same_type pow(const same_type &f, const same_type &g)
+            {
+                if (_is_constant(g))
+                    return pow(f, g._value_list[0]);
+                if (f._value_list[0] <= 0.0)
+                    throw std::runtime_error("f <= 0 at math::pow_f_g<_high_order_dual_number>");
+                return exp(g * log(f));
+            }
+
+            // x != 0 || y != 0
+            friend same_type hypot(const same_type &x, const same_type &y)
+            {
+                if (x._value_list[0] == 0.0 && y._value_list[0] == 0.0)
+                    throw std::runtime_error("x = y = 0 at math::hypot<_high_order_dual_number>");
+                return sqrt(x * x + y * y);
+            }
+
+            // exponential and logarithmic group
+
+            friend same_type exp(const same_type &x)
             {
-                same_type result{_value_list[0] / rhs._value_list[0]};
+                same_type result{};
+                result._value_list[0] = exp(x._value_list[0]);
                 for (size_type i = 1; i < highest_order; ++i)
                 {
                     value_type temp = 0.0;
                     for (size_type j = 1; j <= i; ++j)
-                        temp += rhs._value_list[j] * result._value_list[i - j];
-                    result._value_list[i] = (_value_list[i] - temp) / rhs._value_list[0];
+                        temp += j * x._value_list[j] * result._value_list[i - j];
+                    result._value_list[i] = temp / i;
                 }
                 return result;
             }
 
-            same_type operator/(value_type scalar) const noexcept
+            friend same_type log(const same_type &x)
             {
-                same_type result{_value_list[0] / scalar};
+                if (x._value_list[0] <= 0.0)
+                    throw std::runtime_error("x <= 0 at math::log<_high_order_dual_number>");
+                same_type result{};
+                result._value_list[0] = log(x._value_list[0]);
                 for (size_type i = 1; i < highest_order; ++i)
-                    result._value_list[i] = _value_list[i] / scalar;
+                {
+                    value_type temp = 0.0;
+                    for (size_type j = 1; j < i; ++j)
+                        temp += j * result._value_list[j] * x._value_list[i - j];
+                    result._value_list[i] = (x._value_list[i] - temp / i) / x._value_list[0];
+                }
                 return result;
             }
 
-            friend same_type operator/(value_type scalar, const same_type &rhs) noexcept
+            // trigonometric group
+
+            // angle of (x, y), x != 0 || y != 0
+            // d(atan2) = (x * dy - y * dx) / (x^2 + y^2), integrated term by term
+            friend same_type atan2(const same_type &y, const same_type &x)
             {
-                same_type result{scalar};
-                result._value_list[1] = 0.0;
-                return result / rhs;
+                same_type r_sq = x * x + y * y;
+                if (r_sq._value_list[0] == 0.0)
+                    throw std::runtime_error("x = y = 0 at math::atan2<_high_order_dual_number>");
+                same_type rate = (x * _derivative_series(y) - y * _derivative_series(x)) / r_sq;
+                same_type result{};
+                result._value_list[0] = atan2(y._value_list[0], x._value_list[0]);
+                for (size_type i = 1; i < highest_order; ++i)
+                    result._value_list[i] = rate._value_list[i - 1] / i;
+                return result;
             }
 
-            // power group
-
-            // exponential and logarithmic group
-
-            // trigonometric group
-
             friend same_type sin(const same_type &x)
             {
-                value_type sin_result = std::sin(x._value_list[0]);
+                value_type sin_result = sin(x._value_list[0]);
                 same_type result{sin_result};
                 if (highest_order == 1)
                     return result;
-                value_type cos_result = std::cos(x._value_list[0]);
+                value_type cos_result = cos(x._value_list[0]);
                 value_type fact = 1.0;
                 for (size_type i = 1; i < highest_order; ++i, fact *= i)
                 {
@@ -158,11 +319,11 @@ namespace math
 
             friend same_type cos(const same_type &x)
             {
-                value_type cos_result = std::cos(x._value_list[0]);
+                value_type cos_result = cos(x._value_list[0]);
                 same_type result{cos_result};
                 if (highest_order == 1)
                     return result;
-                value_type sin_result = std::sin(x._value_list[0]);
+                value_type sin_result = sin(x._value_list[0]);
                 value_type fact = 1.0;
                 for (size_type i = 1; i < highest_order; ++i, fact *= i)
                 {
@@ -206,7 +367,113 @@ namespace math
                 return 1.0 / sin(x);
             }
 
+            // miscellaneous group
+
+            friend same_type fma(const same_type &x, const same_type &y, const same_type &z)
+            {
+                same_type result = z;
+                result._value_list[0] = fma(x._value_list[0], y._value_list[0], z._value_list[0]);
+                for (size_type i = 1; i < highest_order; ++i)
+                    for (size_type j = 0; j <= i; ++j)
+                        result._value_list[i] += x._value_list[j] * y._value_list[i - j];
+                return result;
+            }
+
+            // ties take x, a NaN operand yields the other one as in std::fmin
+            friend same_type fmin(const same_type &x, const same_type &y)
+            {
+                return (y._value_list[0] < x._value_list[0] || isnan(x._value_list[0])) ? y : x;
+            }
+
+            friend same_type fmax(const same_type &x, const same_type &y)
+            {
+                return (y._value_list[0] > x._value_list[0] || isnan(x._value_list[0])) ? y : x;
+            }
+
+            // polynomial group
+
+            // sum coefficients[k] * x^k for k < count through the Taylor coefficients of p at x0,
+            // p(x0 + dx) = sum p^(k)(x0) / k! dx^k, and the variable itself has dx = t
+            friend same_type polyval(const value_type *coefficients, size_type count, const same_type &x) noexcept
+            {
+                same_type shifted = _taylor_shift(coefficients, count, x._value_list[0]);
+                if (_is_variable(x))
+                    return shifted;
+                same_type dx = x;
+                dx._value_list[0] = 0.0;
+                same_type result{};
+                result._value_list[0] = shifted._value_list[highest_order - 1];
+                for (size_type k = highest_order - 1; k-- > 0;)
+                {
+                    result *= dx;
+                    result._value_list[0] += shifted._value_list[k];
+                }
+                return result;
+            }
+
+            friend same_type ratval(const value_type *numerator, size_type numerator_count,
+                                    const value_type *denominator, size_type denominator_count, const same_type &x) noexcept
+            {
+                return polyval(numerator, numerator_count, x) / polyval(denominator, denominator_count, x);
+            }
+
         private:
+            static bool _is_constant(const same_type &x) noexcept
+            {
+                for (size_type i = 1; i < highest_order; ++i)
+                    if (x._value_list[i] != 0.0)
+                        return false;
+                return true;
+            }
+
+            // Taylor coefficients of x', the last one is unknown and left 0
+            static same_type _derivative_series(const same_type &x) noexcept
+            {
+                same_type result{};
+                for (size_type i = 0; i + 1 < highest_order; ++i)
+                    result._value_list[i] = (i + 1) * x._value_list[i + 1];
+                return result;
+            }
+
+            static bool _is_variable(const same_type &x) noexcept
+            {
+                for (size_type i = 1; i < highest_order; ++i)
+                    if (x._value_list[i] != (i == 1 ? 1.0 : 0.0))
+                        return false;
+                return true;
+            }
+
+            // p^(k)(x0) / k! for k < highest_order by nested Horner passes, O(count * highest_order)
+            static same_type _taylor_shift(const value_type *coefficients, size_type count, value_type x0) noexcept
+            {
+                same_type result{};
+                if (count == 0)
+                    return result;
+                result._value_list[0] = coefficients[count - 1];
+                for (size_type i = count - 1; i-- > 0;)
+                {
+                    for (size_type j = std::min(highest_order - 1, count - 1 - i); j > 0; --j)
+                        result._value_list[j] = result._value_list[j] * x0 + result._value_list[j - 1];
+                    result._value_list[0] = result._value_list[0] * x0 + coefficients[i];
+                }
+                return result;
+            }
+
+            // x^n by repeated squaring, no division by x
+            static same_type _repeated_squaring(same_type x, unsigned long n) noexcept
+            {
+                same_type result{};
+                result._value_list[0] = 1.0;
+                for (; n > 0; n >>= 1)
+                {
+                    if (n & 1)
+                        result *= x;
+                    if (n > 1)
+                        x *= x;
+                }
+                return result;
+            }
+
             std::array<value_type, highest_order> _value_list;
         };
 #endif // USE_GLOBAL_FLOATING_POINT_TYPE
@@ -0,0 +1,463 @@
+#ifndef MATH_CALCULUS_HO_BATCH_HPP
+#define MATH_CALCULUS_HO_BATCH_HPP
+
+#include "Config.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+namespace math
+{
+    namespace calculus::details
+    {
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+        // lanes independent Taylor numbers stored coefficient-major, _coefficients[i * lanes + l]
+        // is coefficient i of lane l, so every step of the O(highest_order^2) recurrences runs across
+        // all lanes at once and vectorizes, unlike an array of _high_order_dual_number
+        template <typename value_type = math::real, size_type highest_order = 1, size_type lanes = 8>
+        class _high_order_dual_batch
+        {
+            static_assert(std::is_floating_point<value_type>::value, "_high_order_dual_batch needs a floating point type");
+            static_assert(highest_order > 0 && lanes > 0, "_high_order_dual_batch needs a coefficient and a lane");
+            typedef _high_order_dual_batch<value_type, highest_order, lanes> same_type;
+            typedef std::array<value_type, lanes> lane_type;
+
+        public:
+            _high_order_dual_batch() = default;
+
+            // lane l is the variable x around points[l]
+            explicit _high_order_dual_batch(const value_type *points) : _coefficients{}
+            {
+                std::copy(points, points + lanes, _coefficients.begin());
+                if (highest_order > 1)
+                    std::fill(_lane(1), _lane(1) + lanes, value_type{1.0});
+            }
+
+            // normalized coefficients f^(order) / order! of all lanes, contiguous
+            const value_type *coefficients(size_type order) const noexcept { return _lane(order); }
+
+            value_type derivative(size_type order, size_type lane) const noexcept
+            {
+                value_type fact = 1.0;
+                for (size_type i = 2; i <= order; ++i)
+                    fact *= i;
+                return fact * _lane(order)[lane];
+            }
+
+            // arithmetic group
+
+            same_type &operator+=(const same_type &rhs) noexcept
+            {
+                for (size_type i = 0; i < highest_order * lanes; ++i)
+                    _coefficients[i] += rhs._coefficients[i];
+                return *this;
+            }
+
+            same_type &operator+=(value_type scalar) noexcept
+            {
+                for (size_type l = 0; l < lanes; ++l)
+                    _coefficients[l] += scalar;
+                return *this;
+            }
+
+            same_type &operator-=(const same_type &rhs) noexcept
+            {
+                for (size_type i = 0; i < highest_order * lanes; ++i)
+                    _coefficients[i] -= rhs._coefficients[i];
+                return *this;
+            }
+
+            same_type &operator-=(value_type scalar) noexcept
+            {
+                for (size_type l = 0; l < lanes; ++l)
+                    _coefficients[l] -= scalar;
+                return *this;
+            }
+
+            // top down as in _high_order_dual_number, rhs may be *this
+            same_type &operator*=(const same_type &rhs) noexcept
+            {
+                for (size_type i = highest_order; i-- > 0;)
+                {
+                    lane_type temp{};
+                    for (size_type j = 0; j <= i; ++j)
+                        _accumulate(temp, value_type{1.0}, _lane(j), rhs._lane(i - j));
+                    std::copy(temp.begin(), temp.end(), _lane(i));
+                }
+                return *this;
+            }
+
+            same_type &operator*=(value_type scalar) noexcept
+            {
+                for (size_type i = 0; i < highest_order * lanes; ++i)
+                    _coefficients[i] *= scalar;
+                return *this;
+            }
+
+            same_type &operator/=(const same_type &rhs) noexcept
+            {
+                if (&rhs == this)
+                {
+                    _coefficients.fill(0.0);
+                    std::fill(_lane(0), _lane(0) + lanes, value_type{1.0});
+                    return *this;
+                }
+                lane_type inv;
+                for (size_type l = 0; l < lanes; ++l)
+                    inv[l] = 1.0 / rhs._lane(0)[l];
+                for (size_type i = 0; i < highest_order; ++i)
+                {
+                    lane_type temp;
+                    std::copy(_lane(i), _lane(i) + lanes, temp.begin());
+                    for (size_type j = 1; j <= i; ++j)
+                        _accumulate(temp, value_type{-1.0}, rhs._lane(j), _lane(i - j));
+                    value_type *zi = _lane(i);
+                    for (size_type l = 0; l < lanes; ++l)
+                        zi[l] = temp[l] * inv[l];
+                }
+                return *this;
+            }
+
+            same_type &operator/=(value_type scalar) noexcept
+            {
+                return *this *= 1.0 / scalar;
+            }
+
+            same_type operator-() const noexcept
+            {
+                same_type result;
+                for (size_type i = 0; i < highest_order * lanes; ++i)
+                    result._coefficients[i] = -_coefficients[i];
+                return result;
+            }
+
+            friend same_type operator+(same_type lhs, const same_type &rhs) noexcept { lhs += rhs; return lhs; }
+            friend same_type operator+(same_type lhs, value_type scalar) noexcept { lhs += scalar; return lhs; }
+            friend same_type operator+(value_type scalar, same_type rhs) noexcept { rhs += scalar; return rhs; }
+
+            friend same_type operator-(same_type lhs, const same_type &rhs) noexcept { lhs -= rhs; return lhs; }
+            friend same_type operator-(same_type lhs, value_type scalar) noexcept { lhs -= scalar; return lhs; }
+            friend same_type operator-(value_type scalar, const same_type &rhs) noexcept
+            {
+                same_type result = -rhs;
+                result += scalar;
+                return result;
+            }
+
+            friend same_type operator*(same_type lhs, const same_type &rhs) noexcept { lhs *= rhs; return lhs; }
+            friend same_type operator*(same_type lhs, value_type scalar) noexcept { lhs *= scalar; return lhs; }
+            friend same_type operator*(value_type scalar, same_type rhs) noexcept { rhs *= scalar; return rhs; }
+
+            friend same_type operator/(same_type lhs, const same_type &rhs) noexcept { lhs /= rhs; return lhs; }
+            friend same_type operator/(same_type lhs, value_type scalar) noexcept { lhs /= scalar; return lhs; }
+
+            friend same_type operator/(value_type scalar, const same_type &rhs) noexcept
+            {
+                same_type result{};
+                for (size_type l = 0; l < lanes; ++l)
+                    result._coefficients[l] = scalar;
+                result /= rhs;
+                return result;
+            }
+
+            // power group
+
+            friend same_type sqrt(const same_type &x)
+            {
+                _check_positive(x, "x <= 0 at math::sqrt<_high_order_dual_batch>");
+                same_type result{};
+                lane_type inv;
+                for (size_type l = 0; l < lanes; ++l)
+                {
+                    result._coefficients[l] = std::sqrt(x._coefficients[l]);
+                    inv[l] = 0.5 / result._coefficients[l];
+                }
+                for (size_type i = 1; i < highest_order; ++i)
+                {
+                    lane_type temp;
+                    std::copy(x._lane(i), x._lane(i) + lanes, temp.begin());
+                    for (size_type j = 1; j < i; ++j)
+                        _accumulate(temp, value_type{-1.0}, result._lane(j), result._lane(i - j));
+                    for (size_type l = 0; l < lanes; ++l)
+                        result._lane(i)[l] = temp[l] * inv[l];
+                }
+                return result;
+            }
+
+            // x != 0 in every lane unless p is a natural number, negative x is fine for integral p
+            friend same_type pow(const same_type &x, value_type p)
+            {
+                for (size_type l = 0; l < lanes; ++l)
+                    if (x._coefficients[l] == 0.0)
+                    {
+                        if (p < 0.0 || p != std::floor(p))
+                            throw std::runtime_error("x = 0 at math::pow_x_n<_high_order_dual_batch>");
+                        return _repeated_squaring(x, static_cast<unsigned long>(p));
+                    }
+                same_type result{};
+                lane_type inv;
+                for (size_type l = 0; l < lanes; ++l)
+                {
+                    result._coefficients[l] = std::pow(x._coefficients[l], p);
+                    inv[l] = 1.0 / x._coefficients[l];
+                }
+                for (size_type i = 1; i < highest_order; ++i)
+                {
+                    lane_type temp{};
+                    for (size_type j = 1; j <= i; ++j)
+                        _accumulate(temp, (p + 1.0) * j - value_type(i), x._lane(j), result._lane(i - j));
+                    for (size_type l = 0; l < lanes; ++l)
+                        result._lane(i)[l] = temp[l] * inv[l] / i;
+                }
+                return result;
+            }
+
+            // f^g = exp(g * log(f)), f > 0 in every lane
+            friend same_type pow(const same_type &f, const same_type &g)
+            {
+                return exp(g * log(f));
+            }
+
+            friend same_type hypot(const same_type &x, const same_type &y)
+            {
+                return sqrt(x * x + y * y);
+            }
+
+            // exponential and logarithmic group
+
+            friend same_type exp(const same_type &x) noexcept
+            {
+                same_type result{};
+                for (size_type l = 0; l < lanes; ++l)
+                    result._coefficients[l] = std::exp(x._coefficients[l]);
+                for (size_type i = 1; i < highest_order; ++i)
+                {
+                    lane_type temp{};
+                    for (size_type j = 1; j <= i; ++j)
+                        _accumulate(temp, value_type(j), x._lane(j), result._lane(i - j));
+                    for (size_type l = 0; l < lanes; ++l)
+                        result._lane(i)[l] = temp[l] / i;
+                }
+                return result;
+            }
+
+            friend same_type log(const same_type &x)
+            {
+                _check_positive(x, "x <= 0 at math::log<_high_order_dual_batch>");
+                same_type result{};
+                lane_type inv;
+                for (size_type l = 0; l < lanes; ++l)
+                {
+                    result._coefficients[l] = std::log(x._coefficients[l]);
+                    inv[l] = 1.0 / x._coefficients[l];
+                }
+                for (size_type i = 1; i < highest_order; ++i)
+                {
+                    lane_type temp{};
+                    for (size_type j = 1; j < i; ++j)
+                        _accumulate(temp, value_type(j), result._lane(j), x._lane(i - j));
+                    for (size_type l = 0; l < lanes; ++l)
+                        result._lane(i)[l] = (x._lane(i)[l] - temp[l] / i) * inv[l];
+                }
+                return result;
+            }
+
+            // trigonometric group
+
+            friend same_type sin(const same_type &x) noexcept
+            {
+                same_type s, c;
+                _sin_cos(x, s, c);
+                return s;
+            }
+
+            friend same_type cos(const same_type &x) noexcept
+            {
+                same_type s, c;
+                _sin_cos(x, s, c);
+                return c;
+            }
+
+            friend same_type tan(const same_type &x) noexcept
+            {
+                same_type s, c;
+                _sin_cos(x, s, c);
+                return s /= c;
+            }
+
+            friend same_type cot(const same_type &x) noexcept
+            {
+                same_type s, c;
+                _sin_cos(x, s, c);
+                return c /= s;
+            }
+
+            friend same_type sec(const same_type &x) noexcept
+            {
+                return 1.0 / cos(x);
+            }
+
+            friend same_type csc(const same_type &x) noexcept
+            {
+                return 1.0 / sin(x);
+            }
+
+            // miscellaneous group
+
+            friend same_type fma(const same_type &x, const same_type &y, const same_type &z) noexcept
+            {
+                same_type result = x;
+                result *= y;
+                result += z;
+                return result;
+            }
+
+            // chosen lane by lane, ties take x, a NaN operand yields the other one as in std::fmin
+            friend same_type fmin(const same_type &x, const same_type &y) noexcept
+            {
+                same_type result = x;
+                for (size_type l = 0; l < lanes; ++l)
+                    if (y._coefficients[l] < x._coefficients[l] || std::isnan(x._coefficients[l]))
+                        for (size_type i = 0; i < highest_order; ++i)
+                            result._lane(i)[l] = y._lane(i)[l];
+                return result;
+            }
+
+            friend same_type fmax(const same_type &x, const same_type &y) noexcept
+            {
+                same_type result = x;
+                for (size_type l = 0; l < lanes; ++l)
+                    if (y._coefficients[l] > x._coefficients[l] || std::isnan(x._coefficients[l]))
+                        for (size_type i = 0; i < highest_order; ++i)
+                            result._lane(i)[l] = y._lane(i)[l];
+                return result;
+            }
+
+            // polynomial group
+
+            // sum coefficients[k] * x^k for k < count through the Taylor coefficients of p at every x0,
+            // as in _high_order_dual_number
+            friend same_type polyval(const value_type *coefficients, size_type count, const same_type &x) noexcept
+            {
+                same_type shifted = _taylor_shift(coefficients, count, x._lane(0));
+                if (_is_variable(x))
+                    return shifted;
+                same_type dx = x;
+                std::fill(dx._lane(0), dx._lane(0) + lanes, value_type{});
+                same_type result{};
+                std::copy(shifted._lane(highest_order - 1), shifted._lane(highest_order - 1) + lanes, result._lane(0));
+                for (size_type k = highest_order - 1; k-- > 0;)
+                {
+                    result *= dx;
+                    for (size_type l = 0; l < lanes; ++l)
+                        result._lane(0)[l] += shifted._lane(k)[l];
+                }
+                return result;
+            }
+
+            friend same_type ratval(const value_type *numerator, size_type numerator_count,
+                                    const value_type *denominator, size_type denominator_count, const same_type &x) noexcept
+            {
+                return polyval(numerator, numerator_count, x) / polyval(denominator, denominator_count, x);
+            }
+
+        private:
+            value_type *_lane(size_type order) noexcept { return _coefficients.data() + order * lanes; }
+            const value_type *_lane(size_type order) const noexcept { return _coefficients.data() + order * lanes; }
+
+            // temp[l] += scale * a[l] * b[l], the inner loop of every recurrence
+            static void _accumulate(lane_type &temp, value_type scale, const value_type *a, const value_type *b) noexcept
+            {
+                for (size_type l = 0; l < lanes; ++l)
+                    temp[l] += scale * a[l] * b[l];
+            }
+
+            static void _check_positive(const same_type &x, const char *message)
+            {
+                for (size_type l = 0; l < lanes; ++l)
+                    if (!(x._coefficients[l] > 0.0))
+                        throw std::runtime_error(message);
+            }
+
+            static bool _is_variable(const same_type &x) noexcept
+            {
+                for (size_type i = lanes; i < highest_order * lanes; ++i)
+                    if (x._coefficients[i] != (i < 2 * lanes ? 1.0 : 0.0))
+                        return false;
+                return true;
+            }
+
+            // p^(k)(x0[l]) / k! of every lane by nested Horner passes
+            static same_type _taylor_shift(const value_type *coefficients, size_type count, const value_type *x0) noexcept
+            {
+                same_type result{};
+                if (count == 0)
+                    return result;
+                std::fill(result._lane(0), result._lane(0) + lanes, coefficients[count - 1]);
+                for (size_type i = count - 1; i-- > 0;)
+                {
+                    for (size_type j = std::min(highest_order - 1, count - 1 - i); j > 0; --j)
+                    {
+                        value_type *rj = result._lane(j);
+                        const value_type *below = result._lane(j - 1);
+                        for (size_type l = 0; l < lanes; ++l)
+                            rj[l] = rj[l] * x0[l] + below[l];
+                    }
+                    value_type *r0 = result._lane(0);
+                    for (size_type l = 0; l < lanes; ++l)
+                        r0[l] = r0[l] * x0[l] + coefficients[i];
+                }
+                return result;
+            }
+
+            // x^n by repeated squaring, no division by x
+            static same_type _repeated_squaring(same_type x, unsigned long n) noexcept
+            {
+                same_type result{};
+                std::fill(result._lane(0), result._lane(0) + lanes, value_type{1.0});
+                for (; n > 0; n >>= 1)
+                {
+                    if (n & 1)
+                        result *= x;
+                    if (n > 1)
+                        x *= x;
+                }
+                return result;
+            }
+
+            // s' = c * x', c' = -s * x', integrated term by term
+            static void _sin_cos(const same_type &x, same_type &s, same_type &c) noexcept
+            {
+                s = same_type{};
+                c = same_type{};
+                for (size_type l = 0; l < lanes; ++l)
+                {
+                    s._coefficients[l] = std::sin(x._coefficients[l]);
+                    c._coefficients[l] = std::cos(x._coefficients[l]);
+                }
+                for (size_type i = 1; i < highest_order; ++i)
+                {
+                    lane_type s_temp{}, c_temp{};
+                    for (size_type j = 1; j <= i; ++j)
+                    {
+                        _accumulate(s_temp, value_type(j), x._lane(j), c._lane(i - j));
+                        _accumulate(c_temp, -value_type(j), x._lane(j), s._lane(i - j));
+                    }
+                    for (size_type l = 0; l < lanes; ++l)
+                    {
+                        s._lane(i)[l] = s_temp[l] / i;
+                        c._lane(i)[l] = c_temp[l] / i;
+                    }
+                }
+            }
+
+            std::array<value_type, highest_order * lanes> _coefficients;
+        };
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+    } // namespace math::calculus::details
+} // namespace math
+
+#endif // MATH_CALCULUS_HO_BATCH_HPP
@@ -4,13 +4,77 @@
 #include "Config.hpp"
 
 #include "HOAutoDiff.hpp"
+#include "HOBatch.hpp"
+#include "Utility/Parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
 
 namespace math
 {
     namespace calculus::details
     {
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+        // points [first, last) through f, lanes at a time; the short last batch repeats its last point
+        template <size_type highest_order, size_type lanes, typename func_tp, typename value_type>
+        void _high_order_batches(func_tp &f, const value_type *points, size_type first, size_type last,
+                                 const std::array<value_type, highest_order> &factorial, value_type *result)
+        {
+            std::array<value_type, lanes> batch_points;
+            for (size_type begin = first; begin < last; begin += lanes)
+            {
+                size_type width = std::min(lanes, last - begin);
+                std::copy(points + begin, points + begin + width, batch_points.begin());
+                std::fill(batch_points.begin() + width, batch_points.end(), points[begin + width - 1]);
 
+                auto y = f(_high_order_dual_batch<value_type, highest_order, lanes>{batch_points.data()});
+                for (size_type k = 0; k < highest_order; ++k)
+                {
+                    const value_type *coefficient = y.coefficients(k);
+                    for (size_type l = 0; l < width; ++l)
+                        result[(begin + l) * highest_order + k] = factorial[k] * coefficient[l];
+                }
+            }
+        }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
     }  // namespace math::calculus::details
+
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace calculus
+    {
+        // result[p * highest_order + k] = f^(k)(points[p]) for p < count and k < highest_order,
+        // f is evaluated on _high_order_dual_batch of lanes points at a time;
+        // threads > 1 splits the batches, so f must then be safe to call concurrently
+        template <size_type highest_order, size_type lanes = 8, typename func_tp, typename value_type>
+        void high_order_derivatives(func_tp f, const value_type *points, size_type count, value_type *result,
+                                    size_type threads = 1)
+        {
+            std::array<value_type, highest_order> factorial;
+            factorial[0] = 1.0;
+            for (size_type k = 1; k < highest_order; ++k)
+                factorial[k] = factorial[k - 1] * k;
+
+            size_type batches = (count + lanes - 1) / lanes;
+            utility::parallel_for(batches, threads,
+                                  [&](size_type first, size_type last)
+                                  {
+                                      details::_high_order_batches<highest_order, lanes>(
+                                          f, points, first * lanes, std::min(last * lanes, count), factorial, result);
+                                  });
+        }
+
+        template <size_type highest_order, size_type lanes = 8, typename func_tp, typename value_type>
+        std::vector<value_type> high_order_derivatives(func_tp f, const std::vector<value_type> &points,
+                                                       size_type threads = 1)
+        {
+            std::vector<value_type> result(points.size() * highest_order);
+            high_order_derivatives<highest_order, lanes>(f, points.data(), static_cast<size_type>(points.size()),
+                                                         result.data(), threads);
+            return result;
+        }
+    } // namespace math::calculus
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
 } // namespace math
 
-#endif // MATH_CALCULUS_HO_DERIVATIVE_HPP
\ No newline at end of file
+#endif // MATH_CALCULUS_HO_DERIVATIVE_HPP
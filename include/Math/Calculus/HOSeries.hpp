@@ -0,0 +1,572 @@
+#ifndef MATH_CALCULUS_HO_SERIES_HPP
+#define MATH_CALCULUS_HO_SERIES_HPP
+
+#include "Config.hpp"
+
+#include "Utility/ScalarTraits.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace math
+{
+    namespace calculus::details
+    {
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+        // the quadratic recurrences of _high_order_dual_number win up to these many coefficients (measured with double),
+        // above them products use Karatsuba and then FFT, reciprocal, log and exp use Newton iteration
+        constexpr size_type _karatsuba_base = 32;
+        constexpr size_type _product_crossover = 192;
+        constexpr size_type _fft_crossover = 768;
+        constexpr size_type _newton_crossover = 2048;
+        constexpr size_type _exp_crossover = 4096;
+
+        // out[k] = sum(a[i] * b[k - i]) for k < n, out must not alias a or b
+        template <typename value_type>
+        void _truncated_product(const value_type *a, const value_type *b, size_type n, value_type *out) noexcept
+        {
+            for (size_type k = 0; k < n; ++k)
+            {
+                value_type temp = 0.0;
+                for (size_type i = 0; i <= k; ++i)
+                    temp += a[i] * b[k - i];
+                out[k] = temp;
+            }
+        }
+
+        // full product of a and b of n coefficients each into out[0, 2n - 1),
+        // scratch holds 4 * (n + log2(n)) values and is reused by every level of the recursion
+        template <typename value_type>
+        void _karatsuba(const value_type *a, const value_type *b, size_type n, value_type *out, value_type *scratch) noexcept
+        {
+            if (n <= _karatsuba_base)
+            {
+                std::fill(out, out + 2 * n - 1, value_type{0.0});
+                for (size_type i = 0; i < n; ++i)
+                    for (size_type j = 0; j < n; ++j)
+                        out[i + j] += a[i] * b[j];
+                return;
+            }
+            // a = a0 + a1 t^m with a0 of m and a1 of h >= m coefficients, likewise b
+            size_type m = n / 2, h = n - m;
+            _karatsuba(a, b, m, out, scratch);
+            _karatsuba(a + m, b + m, h, out + 2 * m, scratch);
+            out[2 * m - 1] = 0.0;
+
+            value_type *sum_a = scratch, *sum_b = scratch + h, *middle = scratch + 2 * h;
+            for (size_type i = 0; i < h; ++i)
+            {
+                sum_a[i] = a[m + i] + (i < m ? a[i] : value_type{0.0});
+                sum_b[i] = b[m + i] + (i < m ? b[i] : value_type{0.0});
+            }
+            _karatsuba(sum_a, sum_b, h, middle, scratch + 4 * h);
+            for (size_type i = 0; i + 1 < 2 * m; ++i)
+                middle[i] -= out[i];
+            for (size_type i = 0; i + 1 < 2 * h; ++i)
+                middle[i] -= out[2 * m + i];
+            for (size_type i = 0; i + 1 < 2 * h; ++i)
+                out[m + i] += middle[i];
+        }
+
+        // largest rate with |c[k]| * 2^(rate * k) <= |c[first]| * 2^(rate * first) past the first nonzero coefficient,
+        // so the rescaled series never rises above its leading term, and the index past the last nonzero coefficient;
+        // infinity for a monomial, which stays flat under any rescaling
+        template <typename value_type>
+        double _decay_rate(const value_type *c, size_type n, size_type &support) noexcept
+        {
+            double rate = std::numeric_limits<double>::infinity(), leading = 0.0;
+            size_type first = n;
+            support = 0;
+            for (size_type k = 0; k < n; ++k)
+            {
+                double magnitude = std::fabs(static_cast<double>(c[k]));
+                if (magnitude == 0.0 || !std::isfinite(magnitude))
+                    continue;
+                double l = std::log2(magnitude);
+                support = k + 1;
+                if (first == n)
+                {
+                    first = k;
+                    leading = l;
+                }
+                else
+                    rate = std::min(rate, (leading - l) / (k - first));
+            }
+            return rate;
+        }
+
+        // out[k] = c[k] * 2^(step * k / 2^18) without forming the power, which may overflow on its own;
+        // the fractional power is a product from three tables of 64 powers of two carried in value_type,
+        // so the scaling costs no precision and differs from any wanted rate by under 2^-18 bits per coefficient
+        template <typename value_type>
+        void _rescale_series(const value_type *c, size_type n, long long step, value_type *out) noexcept
+        {
+            if (step == 0)
+            {
+                std::copy(c, c + n, out);
+                return;
+            }
+            value_type fraction[3][64], root = 2.0;
+            for (int level = 0; level < 3; ++level)
+            {
+                for (int i = 0; i < 6; ++i)
+                    root = sqrt(root);
+                fraction[level][0] = 1.0;
+                for (int r = 1; r < 64; ++r)
+                    fraction[level][r] = fraction[level][r - 1] * root;
+            }
+            for (size_type k = 0; k < n; ++k)
+            {
+                long long total = step * k, whole = total >= 0 ? total >> 18 : -((-total + 262143) >> 18);
+                long long r = total - (whole << 18);
+                value_type scaled = c[k] * fraction[0][r >> 12] * fraction[1][(r >> 6) & 63] * fraction[2][r & 63];
+                out[k] = ldexp(scaled, static_cast<int>(std::max(std::min(whole, 4096ll), -4096ll)));
+            }
+        }
+
+        // in place radix-2 transform of size a power of two, roots[k] = exp(-2 pi i k / size) for k < size / 2,
+        // the inverse runs on the conjugate roots and leaves out the 1 / size factor
+        template <typename value_type>
+        void _fft(std::complex<value_type> *data, size_type size, const std::complex<value_type> *roots,
+                  bool inverse) noexcept
+        {
+            for (size_type i = 1, j = 0; i < size; ++i)
+            {
+                size_type bit = size >> 1;
+                for (; j & bit; bit >>= 1)
+                    j ^= bit;
+                j ^= bit;
+                if (i < j)
+                    std::swap(data[i], data[j]);
+            }
+            for (size_type length = 2; length <= size; length <<= 1)
+            {
+                size_type half = length / 2, stride = size / length;
+                for (size_type begin = 0; begin < size; begin += length)
+                    for (size_type k = 0; k < half; ++k)
+                    {
+                        std::complex<value_type> w = inverse ? std::conj(roots[k * stride]) : roots[k * stride];
+                        std::complex<value_type> u = data[begin + k], v = data[begin + k + half] * w;
+                        data[begin + k] = u + v;
+                        data[begin + k + half] = u - v;
+                    }
+            }
+        }
+
+        // first n coefficients of a * b from one forward transform of c = a + i b and one inverse transform:
+        // with d[k] = conj(c[-k]), A[k] = (c[k] + d[k]) / 2 and B[k] = (c[k] - d[k]) / 2i, so A B = (c^2 - d^2) / 4i;
+        // std::complex only takes the built-in types, other scalars return false and stay on Karatsuba
+        template <typename value_type>
+        std::enable_if_t<!std::is_floating_point<value_type>::value, bool>
+        _fft_product(const value_type *, const value_type *, size_type, value_type *) noexcept
+        {
+            return false;
+        }
+
+        template <typename value_type>
+        std::enable_if_t<std::is_floating_point<value_type>::value, bool>
+        _fft_product(const value_type *a, const value_type *b, size_type n, value_type *out)
+        {
+            typedef std::complex<value_type> complex_type;
+            size_type size = 1;
+            while (size < 2 * n - 1)
+                size <<= 1;
+            const value_type turn = -2.0 * std::acos(value_type{-1.0}) / size;
+            std::vector<complex_type> roots(size / 2), data(size), product(size);
+            for (size_type k = 0; k < size / 2; ++k)
+                roots[k] = complex_type{std::cos(turn * k), std::sin(turn * k)};
+            for (size_type k = 0; k < n; ++k)
+                data[k] = complex_type{a[k], b[k]};
+            _fft(data.data(), size, roots.data(), false);
+            for (size_type k = 0; k < size; ++k)
+            {
+                complex_type c = data[k], d = std::conj(data[(size - k) & (size - 1)]);
+                complex_type square = c * c - d * d;
+                product[k] = complex_type{square.imag(), -square.real()} / value_type(4.0);
+            }
+            _fft(product.data(), size, roots.data(), true);
+            for (size_type k = 0; k < n; ++k)
+                out[k] = product[k].real() / size;
+            return true;
+        }
+
+        // out[k] = sum(a[i] * b[k - i]) for k < n, quadratic, Karatsuba or FFT depending on n; out may alias a or b
+        // a short polynomial operand is multiplied directly, which is both faster and exact per coefficient;
+        // otherwise the fast kernels only bound the error by the largest coefficients, so a decaying pair is first
+        // rescaled to t -> 2^rate * t, which flattens geometric series and keeps their small high order
+        // coefficients accurate relative to their own size; growing series are never amplified
+        template <typename value_type>
+        void _series_product(const value_type *a, const value_type *b, size_type n, value_type *out)
+        {
+            if (n <= _product_crossover)
+            {
+                value_type small[_product_crossover];
+                _truncated_product(a, b, n, small);
+                std::copy(small, small + n, out);
+                return;
+            }
+            size_type support_a, support_b;
+            double rate = std::min(_decay_rate(a, n, support_a), _decay_rate(b, n, support_b));
+            if (std::min(support_a, support_b) <= _karatsuba_base)
+            {
+                if (support_a > support_b)
+                {
+                    std::swap(a, b);
+                    std::swap(support_a, support_b);
+                }
+                std::vector<value_type> product(n, 0.0);
+                for (size_type i = 0; i < support_a; ++i)
+                    for (size_type k = i; k < n; ++k)
+                        product[k] += a[i] * b[k - i];
+                std::copy(product.begin(), product.end(), out);
+                return;
+            }
+            // rounded down so the rescaled operands never rise, and capped where every coefficient under- or overflows
+            long long step = std::isfinite(rate) ? static_cast<long long>(std::min(std::max(rate, 0.0), 2100.0) * 262144.0) : 0;
+            std::vector<value_type> work(2 * n + 2 * n - 1 + 4 * (n + 32));
+            value_type *scaled_a = work.data(), *scaled_b = scaled_a + n, *product = scaled_b + n;
+            _rescale_series(a, n, step, scaled_a);
+            _rescale_series(b, n, step, scaled_b);
+            if (n <= _fft_crossover || !_fft_product(scaled_a, scaled_b, n, product))
+                _karatsuba(scaled_a, scaled_b, n, product, product + 2 * n - 1);
+            _rescale_series(product, n, -step, out);
+        }
+
+        // 1 / b to n coefficients, b[0] != 0
+        // the first coefficients come from the quadratic recurrence, then r <- r - r * (b * r - 1)
+        // doubles the number of correct coefficients per step; b * r - 1 vanishes below known,
+        // so the correction is a product of half the size
+        template <typename value_type>
+        void _series_reciprocal(const value_type *b, size_type n, value_type *out)
+        {
+            size_type known = std::min(n, _newton_crossover);
+            out[0] = 1.0 / b[0];
+            for (size_type i = 1; i < known; ++i)
+            {
+                value_type temp = 0.0;
+                for (size_type j = 1; j <= i; ++j)
+                    temp += b[j] * out[i - j];
+                out[i] = -temp / b[0];
+            }
+            if (known == n)
+                return;
+
+            std::vector<value_type> r(n, 0.0), e(n);
+            std::copy(out, out + known, r.begin());
+            while (known < n)
+            {
+                size_type next = std::min(2 * known, n), high = next - known;
+                _series_product(b, r.data(), next, e.data());
+                _series_product(r.data(), e.data() + known, high, e.data());
+                for (size_type i = 0; i < high; ++i)
+                    r[known + i] = -e[i];
+                known = next;
+            }
+            std::copy(r.begin(), r.end(), out);
+        }
+
+        // log(b) to n coefficients, b[0] > 0, as log(b[0]) + integral(b' / b)
+        template <typename value_type>
+        void _series_log(const value_type *b, size_type n, value_type *out)
+        {
+            if (n <= _newton_crossover)
+            {
+                out[0] = log(b[0]);
+                for (size_type i = 1; i < n; ++i)
+                {
+                    value_type temp = 0.0;
+                    for (size_type j = 1; j < i; ++j)
+                        temp += j * out[j] * b[i - j];
+                    out[i] = (b[i] - temp / i) / b[0];
+                }
+                return;
+            }
+            std::vector<value_type> rate(n - 1), reciprocal(n - 1);
+            for (size_type i = 1; i < n; ++i)
+                rate[i - 1] = i * b[i];
+            _series_reciprocal(b, n - 1, reciprocal.data());
+            _series_product(rate.data(), reciprocal.data(), n - 1, rate.data());
+            out[0] = log(b[0]);
+            for (size_type i = 1; i < n; ++i)
+                out[i] = rate[i - 1] / i;
+        }
+
+        // exp(a) to n coefficients, Newton iteration y <- y + y * (a - log(y)) above the quadratic start,
+        // a - log(y) vanishes below known like the residual of the reciprocal
+        template <typename value_type>
+        void _series_exp(const value_type *a, size_type n, value_type *out)
+        {
+            size_type known = std::min(n, _exp_crossover);
+            out[0] = exp(a[0]);
+            for (size_type i = 1; i < known; ++i)
+            {
+                value_type temp = 0.0;
+                for (size_type j = 1; j <= i; ++j)
+                    temp += j * a[j] * out[i - j];
+                out[i] = temp / i;
+            }
+            if (known == n)
+                return;
+
+            std::vector<value_type> y(n, 0.0), l(n);
+            std::copy(out, out + known, y.begin());
+            while (known < n)
+            {
+                size_type next = std::min(2 * known, n), high = next - known;
+                _series_log(y.data(), next, l.data());
+                for (size_type i = known; i < next; ++i)
+                    l[i] = a[i] - l[i];
+                _series_product(y.data(), l.data() + known, high, l.data());
+                for (size_type i = 0; i < high; ++i)
+                    y[known + i] = l[i];
+                known = next;
+            }
+            std::copy(y.begin(), y.end(), out);
+        }
+
+        // truncated Taylor series with the number of coefficients chosen at run time,
+        // coefficient k is f^(k)(x0) / k! like _high_order_dual_number; operands must have the same size
+        template <typename value_type = math::real>
+        class _taylor_series
+        {
+            static_assert(utility::scalar_traits<value_type>::is_scalar, "_taylor_series needs a scalar value type");
+            typedef _taylor_series<value_type> same_type;
+
+        public:
+            _taylor_series() = default;
+
+            // value + t, the independent variable at value
+            static same_type variable(value_type value, size_type count)
+            {
+                same_type result = constant(value, count);
+                if (count > 1)
+                    result._value_list[1] = 1.0;
+                return result;
+            }
+
+            static same_type constant(value_type value, size_type count)
+            {
+                if (count == 0)
+                    throw std::runtime_error("count = 0 at math::constant<_taylor_series>");
+                same_type result;
+                result._value_list.assign(count, 0.0);
+                result._value_list[0] = value;
+                return result;
+            }
+
+            size_type size() const noexcept { return static_cast<size_type>(_value_list.size()); }
+            value_type operator[](size_type k) const noexcept { return _value_list[k]; }
+            value_type &operator[](size_type k) noexcept { return _value_list[k]; }
+
+            value_type derivative(size_type order) const noexcept
+            {
+                value_type fact = 1.0;
+                for (size_type i = 2; i <= order; ++i)
+                    fact *= i;
+                return fact * _value_list[order];
+            }
+
+            same_type &operator+=(const same_type &rhs)
+            {
+                _check_size(*this, rhs, "operator+=");
+                for (size_type i = 0; i < size(); ++i)
+                    _value_list[i] += rhs._value_list[i];
+                return *this;
+            }
+
+            same_type &operator+=(value_type scalar) noexcept
+            {
+                _value_list[0] += scalar;
+                return *this;
+            }
+
+            same_type &operator-=(const same_type &rhs)
+            {
+                _check_size(*this, rhs, "operator-=");
+                for (size_type i = 0; i < size(); ++i)
+                    _value_list[i] -= rhs._value_list[i];
+                return *this;
+            }
+
+            same_type &operator-=(value_type scalar) noexcept
+            {
+                _value_list[0] -= scalar;
+                return *this;
+            }
+
+            same_type &operator*=(const same_type &rhs)
+            {
+                _check_size(*this, rhs, "operator*=");
+                _series_product(_value_list.data(), rhs._value_list.data(), size(), _value_list.data());
+                return *this;
+            }
+
+            same_type &operator*=(value_type scalar) noexcept
+            {
+                for (value_type &c : _value_list)
+                    c *= scalar;
+                return *this;
+            }
+
+            same_type &operator/=(const same_type &rhs)
+            {
+                *this *= 1.0 / rhs;
+                return *this;
+            }
+
+            same_type &operator/=(value_type scalar) noexcept
+            {
+                for (value_type &c : _value_list)
+                    c /= scalar;
+                return *this;
+            }
+
+            same_type operator-() const
+            {
+                same_type result = *this;
+                for (value_type &c : result._value_list)
+                    c = -c;
+                return result;
+            }
+
+            friend same_type operator+(same_type lhs, const same_type &rhs) { lhs += rhs; return lhs; }
+            friend same_type operator+(same_type lhs, value_type scalar) { lhs += scalar; return lhs; }
+            friend same_type operator+(value_type scalar, same_type rhs) { rhs += scalar; return rhs; }
+
+            friend same_type operator-(same_type lhs, const same_type &rhs) { lhs -= rhs; return lhs; }
+            friend same_type operator-(same_type lhs, value_type scalar) { lhs -= scalar; return lhs; }
+            friend same_type operator-(value_type scalar, const same_type &rhs) { same_type result = -rhs; result += scalar; return result; }
+
+            friend same_type operator*(same_type lhs, const same_type &rhs) { lhs *= rhs; return lhs; }
+            friend same_type operator*(same_type lhs, value_type scalar) { lhs *= scalar; return lhs; }
+            friend same_type operator*(value_type scalar, same_type rhs) { rhs *= scalar; return rhs; }
+
+            friend same_type operator/(same_type lhs, const same_type &rhs) { lhs /= rhs; return lhs; }
+            friend same_type operator/(same_type lhs, value_type scalar) { lhs /= scalar; return lhs; }
+
+            // reciprocal series scaled by scalar
+            friend same_type operator/(value_type scalar, const same_type &rhs)
+            {
+                if (rhs._value_list[0] == 0.0)
+                    throw std::runtime_error("x = 0 at math::operator/<_taylor_series>");
+                same_type result{rhs.size()};
+                _series_reciprocal(rhs._value_list.data(), rhs.size(), result._value_list.data());
+                result *= scalar;
+                return result;
+            }
+
+            // power group
+
+            friend same_type sqrt(const same_type &x)
+            {
+                if (x._value_list[0] <= 0.0)
+                    throw std::runtime_error("x <= 0 at math::sqrt<_taylor_series>");
+                if (x.size() > _newton_crossover)
+                    return exp(0.5 * log(x));
+                same_type result{x.size()};
+                result._value_list[0] = sqrt(x._value_list[0]);
+                for (size_type i = 1; i < x.size(); ++i)
+                {
+                    value_type temp = x._value_list[i];
+                    for (size_type j = 1; j < i; ++j)
+                        temp -= result._value_list[j] * result._value_list[i - j];
+                    result._value_list[i] = temp / (2.0 * result._value_list[0]);
+                }
+                return result;
+            }
+
+            // x^p = exp(p * log(x)) for x > 0
+            friend same_type pow(const same_type &x, value_type p)
+            {
+                if (x._value_list[0] <= 0.0)
+                    throw std::runtime_error("x <= 0 at math::pow_x_n<_taylor_series>");
+                return exp(p * log(x));
+            }
+
+            // exponential and logarithmic group
+
+            friend same_type exp(const same_type &x)
+            {
+                same_type result{x.size()};
+                _series_exp(x._value_list.data(), x.size(), result._value_list.data());
+                return result;
+            }
+
+            friend same_type log(const same_type &x)
+            {
+                if (x._value_list[0] <= 0.0)
+                    throw std::runtime_error("x <= 0 at math::log<_taylor_series>");
+                same_type result{x.size()};
+                _series_log(x._value_list.data(), x.size(), result._value_list.data());
+                return result;
+            }
+
+            // trigonometric group
+
+            // sin' = cos * x' and cos' = -sin * x', integrated term by term together
+            friend same_type sin(const same_type &x)
+            {
+                same_type s{x.size()}, c{x.size()};
+                _sin_cos(x, s, c);
+                return s;
+            }
+
+            friend same_type cos(const same_type &x)
+            {
+                same_type s{x.size()}, c{x.size()};
+                _sin_cos(x, s, c);
+                return c;
+            }
+
+        private:
+            explicit _taylor_series(size_type count) : _value_list(count, 0.0) {}
+
+            static void _check_size(const same_type &lhs, const same_type &rhs, const char *name)
+            {
+                if (lhs.size() != rhs.size())
+                    throw std::runtime_error(std::string("size mismatch at math::") + name + "<_taylor_series>");
+            }
+
+            static void _sin_cos(const same_type &x, same_type &s, same_type &c) noexcept
+            {
+                s._value_list[0] = sin(x._value_list[0]);
+                c._value_list[0] = cos(x._value_list[0]);
+                for (size_type i = 1; i < x.size(); ++i)
+                {
+                    value_type sin_temp = 0.0, cos_temp = 0.0;
+                    for (size_type j = 1; j <= i; ++j)
+                    {
+                        sin_temp += j * x._value_list[j] * c._value_list[i - j];
+                        cos_temp += j * x._value_list[j] * s._value_list[i - j];
+                    }
+                    s._value_list[i] = sin_temp / i;
+                    c._value_list[i] = -cos_temp / i;
+                }
+            }
+
+            std::vector<value_type> _value_list;
+        };
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+    } // namespace math::calculus::details
+
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    namespace calculus
+    {
+        // the independent variable at value with count Taylor coefficients,
+        // products, division, exp and log switch to Karatsuba and Newton iteration for large counts
+        template <typename value_type = math::real>
+        details::_taylor_series<value_type> taylor_series(value_type value, size_type count)
+        {
+            return details::_taylor_series<value_type>::variable(value, count);
+        }
+    } // namespace math::calculus
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math
+
+#endif // MATH_CALCULUS_HO_SERIES_HPP
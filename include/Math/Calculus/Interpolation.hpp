@@ -0,0 +1,502 @@
+#ifndef MATH_CALCULUS_INTERPOLATION_HPP
+#define MATH_CALCULUS_INTERPOLATION_HPP
+
+#include "Config.hpp"
+
+#include "FOAutoDiff.hpp"
+#include "HOAutoDiff.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// every interpolant is stored as one polynomial per interval or cell in the local coordinates
+// u = x - x[i] (and v = y - y[j]), so a lookup is a search plus one Horner evaluation on contiguous
+// coefficients, and dual or Taylor arguments get their derivatives from polyval; outside the knots
+// the first and last pieces are extended
+namespace math::calculus
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    enum class interpolation_kind
+    {
+        linear,
+        // piecewise cubic Hermite with Fritsch-Butland slopes, no overshoot between monotone data
+        monotone_cubic,
+        // C2 cubic spline with zero second derivative at both ends
+        natural_cubic
+    };
+
+    namespace details
+    {
+        template <typename value_type>
+        std::enable_if_t<std::is_floating_point<value_type>::value, value_type> _real_part(value_type x) noexcept
+        {
+            return x;
+        }
+
+        template <typename value_type>
+        value_type _real_part(const _dual_number<value_type> &x) noexcept
+        {
+            return x.real;
+        }
+
+        template <typename value_type, size_type highest_order>
+        value_type _real_part(const _high_order_dual_number<value_type, highest_order> &x) noexcept
+        {
+            return x.derivative(0);
+        }
+
+        // interval i with knots[i] <= x < knots[i + 1], clamped to [0, count - 2];
+        // equally spaced knots are found by one multiplication, others by a branch-free descent of a complete
+        // Eytzinger tree whose depth is fixed, so batched queries take their steps in lockstep and vectorize
+        template <typename value_type>
+        class _knot_search
+        {
+        public:
+            _knot_search() = default;
+
+            _knot_search(const value_type *knots, size_type count) : _first(knots[0]), _count(count)
+            {
+                value_type step = (knots[count - 1] - knots[0]) / (count - 1);
+                value_type tolerance = 4.0 * std::numeric_limits<value_type>::epsilon() *
+                                       std::max(std::abs(knots[0]), std::abs(knots[count - 1]));
+                _uniform = true;
+                for (size_type k = 0; k < count && _uniform; ++k)
+                    _uniform = std::abs(knots[k] - (knots[0] + k * step)) <= tolerance;
+                _inverse_step = 1.0 / step;
+                if (_uniform)
+                    return;
+
+                // sorted knots padded with +inf to 2^depth - 1, laid out in breadth-first order
+                _depth = 1;
+                while ((size_type{1} << _depth) - 1 < count)
+                    ++_depth;
+                size_type size = (size_type{1} << _depth) - 1;
+                _tree.assign(size + 1, std::numeric_limits<value_type>::infinity());
+                _rank.assign(size + 1, count);
+                size_type next = 0;
+                _build(knots, 1, size, next);
+            }
+
+            size_type interval(value_type x) const noexcept
+            {
+                return _uniform ? _uniform_interval(x) : _clamp(_upper_bound(x));
+            }
+
+            // intervals of count queries, the tree descent runs on blocks of _block queries at once
+            void intervals(const value_type *x, size_type count, size_type *result) const noexcept
+            {
+                if (_uniform)
+                {
+                    for (size_type q = 0; q < count; ++q)
+                        result[q] = _uniform_interval(x[q]);
+                    return;
+                }
+                size_type q = 0;
+                for (; q + _block <= count; q += _block)
+                {
+                    std::array<size_type, _block> node, upper;
+                    node.fill(1);
+                    upper.fill(_count);
+                    for (size_type d = 0; d < _depth; ++d)
+                        for (size_type b = 0; b < _block; ++b)
+                        {
+                            bool right = _tree[node[b]] <= x[q + b];
+                            upper[b] = right ? upper[b] : _rank[node[b]];
+                            node[b] = 2 * node[b] + right;
+                        }
+                    for (size_type b = 0; b < _block; ++b)
+                        result[q + b] = _clamp(upper[b]);
+                }
+                for (; q < count; ++q)
+                    result[q] = _clamp(_upper_bound(x[q]));
+            }
+
+        private:
+            static constexpr size_type _block = 8;
+
+            void _build(const value_type *knots, size_type node, size_type size, size_type &next)
+            {
+                if (node > size)
+                    return;
+                _build(knots, 2 * node, size, next);
+                if (next < _count)
+                    _tree[node] = knots[next];
+                _rank[node] = next++;
+                _build(knots, 2 * node + 1, size, next);
+            }
+
+            // index of the first knot > x, count when there is none
+            size_type _upper_bound(value_type x) const noexcept
+            {
+                size_type node = 1, upper = _count;
+                for (size_type d = 0; d < _depth; ++d)
+                {
+                    bool right = _tree[node] <= x;
+                    upper = right ? upper : _rank[node];
+                    node = 2 * node + right;
+                }
+                return upper;
+            }
+
+            size_type _clamp(size_type upper) const noexcept
+            {
+                upper = std::min(upper, _count - 1);
+                return upper == 0 ? 0 : upper - 1;
+            }
+
+            // NaN falls to the first interval
+            size_type _uniform_interval(value_type x) const noexcept
+            {
+                value_type t = std::floor((x - _first) * _inverse_step);
+                value_type last = static_cast<value_type>(_count - 2);
+                return t >= 0.0 ? static_cast<size_type>(t < last ? t : last) : 0;
+            }
+
+            value_type _first = 0.0;
+            value_type _inverse_step = 0.0;
+            size_type _count = 0;
+            bool _uniform = true;
+            size_type _depth = 0;
+            std::vector<value_type> _tree;
+            std::vector<size_type> _rank;
+        };
+
+        template <typename value_type>
+        void _check_knots(const std::vector<value_type> &knots)
+        {
+            if (knots.size() < 2)
+                throw std::runtime_error("fewer than 2 knots at math::calculus::interpolant");
+            for (std::size_t k = 1; k < knots.size(); ++k)
+                if (!(knots[k - 1] < knots[k]))
+                    throw std::runtime_error("knots are not strictly increasing at math::calculus::interpolant");
+        }
+
+        // knot slopes of the cubic kinds for values f[k * stride], k < count
+        template <typename value_type>
+        void _knot_slopes(const std::vector<value_type> &knots, const value_type *f, size_type stride,
+                          interpolation_kind kind, value_type *slope, size_type slope_stride)
+        {
+            size_type count = static_cast<size_type>(knots.size());
+            std::vector<value_type> h(count - 1), delta(count - 1);
+            for (size_type k = 0; k + 1 < count; ++k)
+            {
+                h[k] = knots[k + 1] - knots[k];
+                delta[k] = (f[(k + 1) * stride] - f[k * stride]) / h[k];
+            }
+            if (count == 2)
+            {
+                slope[0] = slope[slope_stride] = delta[0];
+                return;
+            }
+
+            if (kind == interpolation_kind::natural_cubic)
+            {
+                // second derivatives from the tridiagonal system with m[0] = m[count - 1] = 0, by Thomas elimination
+                std::vector<value_type> m(count, 0.0), diagonal(count, 0.0), rhs(count, 0.0);
+                for (size_type k = 1; k + 1 < count; ++k)
+                {
+                    diagonal[k] = 2.0 * (h[k - 1] + h[k]);
+                    rhs[k] = 6.0 * (delta[k] - delta[k - 1]);
+                }
+                for (size_type k = 2; k + 1 < count; ++k)
+                {
+                    value_type factor = h[k - 1] / diagonal[k - 1];
+                    diagonal[k] -= factor * h[k - 1];
+                    rhs[k] -= factor * rhs[k - 1];
+                }
+                for (size_type k = count - 1; k-- > 1;)
+                    m[k] = (rhs[k] - h[k] * m[k + 1]) / diagonal[k];
+                for (size_type k = 0; k + 1 < count; ++k)
+                    slope[k * slope_stride] = delta[k] - h[k] * (2.0 * m[k] + m[k + 1]) / 6.0;
+                slope[(count - 1) * slope_stride] = delta[count - 2] + h[count - 2] * (m[count - 2] + 2.0 * m[count - 1]) / 6.0;
+                return;
+            }
+
+            // weighted harmonic mean of the neighbouring secants, 0 at local extrema
+            for (size_type k = 1; k + 1 < count; ++k)
+            {
+                if (delta[k - 1] * delta[k] <= 0.0)
+                    slope[k * slope_stride] = 0.0;
+                else
+                {
+                    value_type w1 = 2.0 * h[k] + h[k - 1], w2 = h[k] + 2.0 * h[k - 1];
+                    slope[k * slope_stride] = (w1 + w2) / (w1 / delta[k - 1] + w2 / delta[k]);
+                }
+            }
+            // one-sided three point ends, limited so they keep the shape
+            auto end_slope = [](value_type h0, value_type h1, value_type d0, value_type d1)
+            {
+                value_type s = ((2.0 * h0 + h1) * d0 - h0 * d1) / (h0 + h1);
+                if (s * d0 <= 0.0)
+                    return value_type{};
+                if (d0 * d1 <= 0.0 && std::abs(s) > 3.0 * std::abs(d0))
+                    return 3.0 * d0;
+                return s;
+            };
+            slope[0] = end_slope(h[0], h[1], delta[0], delta[1]);
+            slope[(count - 1) * slope_stride] = end_slope(h[count - 2], h[count - 3], delta[count - 2], delta[count - 3]);
+        }
+
+        // coefficients of the cubic through (0, f0) and (h, f1) with slopes m0 and m1, in powers of u
+        template <typename value_type>
+        void _hermite_coefficients(value_type f0, value_type f1, value_type m0, value_type m1, value_type h,
+                                   value_type *coefficient, size_type stride) noexcept
+        {
+            value_type delta = (f1 - f0) / h;
+            coefficient[0] = f0;
+            coefficient[stride] = m0;
+            coefficient[2 * stride] = (3.0 * delta - 2.0 * m0 - m1) / h;
+            coefficient[3 * stride] = (m0 + m1 - 2.0 * delta) / (h * h);
+        }
+
+        template <typename value_type>
+        class _interpolant_1d
+        {
+        public:
+            _interpolant_1d(const std::vector<value_type> &x, const std::vector<value_type> &y, interpolation_kind kind)
+                : _knots(x)
+            {
+                _check_knots(x);
+                if (y.size() != x.size())
+                    throw std::runtime_error("x.size() != y.size() at math::calculus::interpolant");
+                size_type count = static_cast<size_type>(x.size());
+                _search = _knot_search<value_type>{x.data(), count};
+                _coefficients.assign(4 * (count - 1), 0.0);
+
+                std::vector<value_type> slope(count);
+                if (kind != interpolation_kind::linear)
+                    _knot_slopes(x, y.data(), 1, kind, slope.data(), 1);
+                for (size_type i = 0; i + 1 < count; ++i)
+                {
+                    value_type h = x[i + 1] - x[i];
+                    if (kind == interpolation_kind::linear)
+                        slope[i] = slope[i + 1] = (y[i + 1] - y[i]) / h;
+                    _hermite_coefficients(y[i], y[i + 1], slope[i], slope[i + 1], h, _coefficients.data() + 4 * i, 1);
+                }
+            }
+
+            // value_type, _dual_number or _high_order_dual_number, the result has the type of x
+            template <typename number_type>
+            number_type operator()(const number_type &x) const
+            {
+                size_type i = _search.interval(_real_part(x));
+                return polyval(_coefficients.data() + 4 * i, 4, x - _knots[i]);
+            }
+
+            // value[q] and, when given, derivative[q] at x[q] for q < count
+            void evaluate(const value_type *x, size_type count, value_type *value, value_type *derivative = nullptr) const
+            {
+                std::array<size_type, _block> interval;
+                for (size_type begin = 0; begin < count; begin += _block)
+                {
+                    size_type width = count - begin < _block ? count - begin : _block;
+                    _search.intervals(x + begin, width, interval.data());
+                    for (size_type b = 0; b < width; ++b)
+                    {
+                        const value_type *c = _coefficients.data() + 4 * interval[b];
+                        value_type u = x[begin + b] - _knots[interval[b]];
+                        value[begin + b] = c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+                        if (derivative != nullptr)
+                            derivative[begin + b] = c[1] + u * (2.0 * c[2] + u * 3.0 * c[3]);
+                    }
+                }
+            }
+
+        private:
+            static constexpr size_type _block = 64;
+
+            std::vector<value_type> _knots;
+            // coefficient p of interval i at [4 * i + p]
+            std::vector<value_type> _coefficients;
+            _knot_search<value_type> _search;
+        };
+
+        // tensor product on the grid x by y, z[i * y.size() + j] = f(x[i], y[j])
+        template <typename value_type>
+        class _interpolant_2d
+        {
+        public:
+            _interpolant_2d(const std::vector<value_type> &x, const std::vector<value_type> &y,
+                            const std::vector<value_type> &z, interpolation_kind kind)
+                : _x(x), _y(y)
+            {
+                _check_knots(x);
+                _check_knots(y);
+                if (z.size() != x.size() * y.size())
+                    throw std::runtime_error("z.size() != x.size() * y.size() at math::calculus::interpolant");
+                size_type nx = static_cast<size_type>(x.size()), ny = static_cast<size_type>(y.size());
+                _x_search = _knot_search<value_type>{x.data(), nx};
+                _y_search = _knot_search<value_type>{y.data(), ny};
+                _cells = ny - 1;
+                _coefficients.assign(16 * (nx - 1) * (ny - 1), 0.0);
+
+                // knot derivatives fx, fy and fxy of the cubic kinds, fxy as the x slopes of fy
+                std::vector<value_type> fx(z.size()), fy(z.size()), fxy(z.size());
+                if (kind != interpolation_kind::linear)
+                {
+                    for (size_type j = 0; j < ny; ++j)
+                        _knot_slopes(x, z.data() + j, ny, kind, fx.data() + j, ny);
+                    for (size_type i = 0; i < nx; ++i)
+                        _knot_slopes(y, z.data() + i * ny, 1, kind, fy.data() + i * ny, 1);
+                    for (size_type j = 0; j < ny; ++j)
+                        _knot_slopes(x, fy.data() + j, ny, kind, fxy.data() + j, ny);
+                }
+
+                for (size_type i = 0; i + 1 < nx; ++i)
+                    for (size_type j = 0; j + 1 < ny; ++j)
+                    {
+                        value_type hx = x[i + 1] - x[i], hy = y[j + 1] - y[j];
+                        size_type k00 = i * ny + j, k01 = k00 + 1, k10 = k00 + ny, k11 = k10 + 1;
+                        // Hermite data, row r is f0, f1, fx0, fx1 in x and column s the same in y
+                        std::array<value_type, 16> g;
+                        if (kind == interpolation_kind::linear)
+                        {
+                            // one-sided differences per cell make the bicubic Hermite bilinear
+                            value_type dx0 = (z[k10] - z[k00]) / hx, dx1 = (z[k11] - z[k01]) / hx;
+                            value_type dy0 = (z[k01] - z[k00]) / hy, dy1 = (z[k11] - z[k10]) / hy;
+                            value_type dxy = (dx1 - dx0) / hy;
+                            g = {z[k00], z[k01], dy0, dy0,
+                                 z[k10], z[k11], dy1, dy1,
+                                 dx0, dx1, dxy, dxy,
+                                 dx0, dx1, dxy, dxy};
+                        }
+                        else
+                            g = {z[k00], z[k01], fy[k00], fy[k01],
+                                 z[k10], z[k11], fy[k10], fy[k11],
+                                 fx[k00], fx[k01], fxy[k00], fxy[k01],
+                                 fx[k10], fx[k11], fxy[k10], fxy[k11]};
+
+                        // powers of u per column, then powers of v per row
+                        std::array<value_type, 16> t;
+                        for (size_type s = 0; s < 4; ++s)
+                            _hermite_coefficients(g[s], g[4 + s], g[8 + s], g[12 + s], hx, t.data() + s, 4);
+                        value_type *a = _coefficients.data() + 16 * (i * _cells + j);
+                        for (size_type p = 0; p < 4; ++p)
+                            _hermite_coefficients(t[4 * p], t[4 * p + 1], t[4 * p + 2], t[4 * p + 3], hy, a + 4 * p, 1);
+                    }
+            }
+
+            value_type operator()(value_type x, value_type y) const noexcept
+            {
+                const value_type *a;
+                value_type u, v;
+                _locate(x, y, a, u, v);
+                value_type result = 0.0;
+                for (size_type p = 4; p-- > 0;)
+                    result = result * u + _row(a + 4 * p, v);
+                return result;
+            }
+
+            // value and gradient in one pass over the coefficients
+            _dual_number<value_type> operator()(const _dual_number<value_type> &x, const _dual_number<value_type> &y) const noexcept
+            {
+                const value_type *a;
+                value_type u, v, value = 0.0, du = 0.0, dv = 0.0;
+                _locate(x.real, y.real, a, u, v);
+                for (size_type p = 4; p-- > 0;)
+                {
+                    const value_type *r = a + 4 * p;
+                    du = du * u + value;
+                    value = value * u + _row(r, v);
+                    dv = dv * u + (r[1] + v * (2.0 * r[2] + v * 3.0 * r[3]));
+                }
+                return _dual_number<value_type>{value, du * x.dual + dv * y.dual};
+            }
+
+            // Taylor coefficients by nested Horner on _high_order_dual_number
+            template <size_type highest_order>
+            _high_order_dual_number<value_type, highest_order> operator()(const _high_order_dual_number<value_type, highest_order> &x,
+                                                                          const _high_order_dual_number<value_type, highest_order> &y) const
+            {
+                const value_type *a;
+                value_type u0, v0;
+                _locate(x.derivative(0), y.derivative(0), a, u0, v0);
+                auto u = x - (x.derivative(0) - u0), v = y - (y.derivative(0) - v0);
+                auto row = [&](size_type p) { return ((v * a[4 * p + 3] + a[4 * p + 2]) * v + a[4 * p + 1]) * v + a[4 * p]; };
+                auto result = row(3);
+                for (size_type p = 3; p-- > 0;)
+                    result = result * u + row(p);
+                return result;
+            }
+
+            // value[q] and, when given, the partial derivatives dx[q], dy[q] at (x[q], y[q]) for q < count
+            void evaluate(const value_type *x, const value_type *y, size_type count, value_type *value,
+                          value_type *dx = nullptr, value_type *dy = nullptr) const
+            {
+                std::array<size_type, _block> ix, iy;
+                for (size_type begin = 0; begin < count; begin += _block)
+                {
+                    size_type width = count - begin < _block ? count - begin : _block;
+                    _x_search.intervals(x + begin, width, ix.data());
+                    _y_search.intervals(y + begin, width, iy.data());
+                    for (size_type b = 0; b < width; ++b)
+                    {
+                        const value_type *a = _coefficients.data() + 16 * (ix[b] * _cells + iy[b]);
+                        value_type u = x[begin + b] - _x[ix[b]], v = y[begin + b] - _y[iy[b]];
+                        value_type f = 0.0, fu = 0.0, fv = 0.0;
+                        for (size_type p = 4; p-- > 0;)
+                        {
+                            const value_type *r = a + 4 * p;
+                            fu = fu * u + f;
+                            f = f * u + _row(r, v);
+                            fv = fv * u + (r[1] + v * (2.0 * r[2] + v * 3.0 * r[3]));
+                        }
+                        value[begin + b] = f;
+                        if (dx != nullptr)
+                            dx[begin + b] = fu;
+                        if (dy != nullptr)
+                            dy[begin + b] = fv;
+                    }
+                }
+            }
+
+        private:
+            static constexpr size_type _block = 64;
+
+            void _locate(value_type x, value_type y, const value_type *&a, value_type &u, value_type &v) const noexcept
+            {
+                size_type i = _x_search.interval(x), j = _y_search.interval(y);
+                a = _coefficients.data() + 16 * (i * _cells + j);
+                u = x - _x[i];
+                v = y - _y[j];
+            }
+
+            static value_type _row(const value_type *r, value_type v) noexcept
+            {
+                return r[0] + v * (r[1] + v * (r[2] + v * r[3]));
+            }
+
+            std::vector<value_type> _x, _y;
+            size_type _cells = 0;
+            // coefficient of u^p v^q in cell (i, j) at [16 * (i * (y.size() - 1) + j) + 4 * p + q]
+            std::vector<value_type> _coefficients;
+            _knot_search<value_type> _x_search, _y_search;
+        };
+    } // namespace math::calculus::details
+
+    // f(x) through the points (x[k], y[k]), x strictly increasing
+    template <typename value_type>
+    details::_interpolant_1d<value_type> interpolant(const std::vector<value_type> &x, const std::vector<value_type> &y,
+                                                     interpolation_kind kind = interpolation_kind::natural_cubic)
+    {
+        return details::_interpolant_1d<value_type>{x, y, kind};
+    }
+
+    // f(x, y) on the grid x by y with z[i * y.size() + j] = f(x[i], y[j])
+    template <typename value_type>
+    details::_interpolant_2d<value_type> interpolant(const std::vector<value_type> &x, const std::vector<value_type> &y,
+                                                     const std::vector<value_type> &z,
+                                                     interpolation_kind kind = interpolation_kind::natural_cubic)
+    {
+        return details::_interpolant_2d<value_type>{x, y, z, kind};
+    }
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus
+
+#endif // MATH_CALCULUS_INTERPOLATION_HPP
@@ -0,0 +1,322 @@
+#ifndef MATH_CALCULUS_TAPE_HPP
+#define MATH_CALCULUS_TAPE_HPP
+
+#include "Config.hpp"
+
+#include "FOAutoDiff.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace math::calculus::details
+{
+#ifndef USE_GLOBAL_FLOATING_POINT_TYPE
+    // input and constant are leaves, comparisons are guards that record the branch taken
+    enum class _tape_op : unsigned char
+    {
+        input, constant, add, sub, mul, div, pow, neg, abs, sq, sqrt, cbrt, exp, log, sin, cos, tan, asin, acos, atan, sinh, cosh, tanh, less, less_equal, equal
+    };
+
+    inline bool _is_guard(_tape_op op) noexcept
+    {
+        return op == _tape_op::less || op == _tape_op::less_equal || op == _tape_op::equal;
+    }
+
+    // lhs and rhs index earlier nodes, so the node order is a topological order
+    template <typename value_type>
+    struct _tape_node
+    {
+        _tape_op op;
+        size_type lhs;
+        size_type rhs;
+        value_type value;
+        value_type tangent;
+    };
+
+    // value and tangent of op applied to a and b, guards evaluate to 1 or 0
+    template <typename value_type>
+    _dual_number<value_type> _evaluate_tape_op(_tape_op op, _dual_number<value_type> a, _dual_number<value_type> b)
+    {
+        switch (op)
+        {
+        case _tape_op::add:
+            return a + b;
+        case _tape_op::sub:
+            return a - b;
+        case _tape_op::mul:
+            return a * b;
+        case _tape_op::div:
+            return a / b;
+        case _tape_op::pow:
+            return math::pow(a, b.real);
+        case _tape_op::neg:
+            return _dual_number<value_type>{-a.real, -a.dual};
+        case _tape_op::abs:
+            return math::abs(a);
+        case _tape_op::sq:
+            return math::sq(a);
+        case _tape_op::sqrt:
+            return math::sqrt(a);
+        case _tape_op::cbrt:
+            return math::cbrt(a);
+        case _tape_op::exp:
+            return math::exp(a);
+        case _tape_op::log:
+            return math::log(a);
+        case _tape_op::sin:
+            return math::sin(a);
+        case _tape_op::cos:
+            return math::cos(a);
+        case _tape_op::tan:
+            return math::tan(a);
+        case _tape_op::asin:
+            return math::asin(a);
+        case _tape_op::acos:
+            return math::acos(a);
+        case _tape_op::atan:
+            return math::atan(a);
+        case _tape_op::sinh:
+            return math::sinh(a);
+        case _tape_op::cosh:
+            return math::cosh(a);
+        case _tape_op::tanh:
+            return math::tanh(a);
+        case _tape_op::less:
+            return _dual_number<value_type>{a.real < b.real ? 1.0 : 0.0};
+        case _tape_op::less_equal:
+            return _dual_number<value_type>{a.real <= b.real ? 1.0 : 0.0};
+        case _tape_op::equal:
+            return _dual_number<value_type>{a.real == b.real ? 1.0 : 0.0};
+        default:
+            throw std::runtime_error("leaf node at math::calculus::details::_evaluate_tape_op");
+        }
+    }
+
+    template <typename value_type>
+    class _recorded_number;
+
+    // straight-line record of one evaluation, values and tangents are computed while recording
+    template <typename value_type = math::real>
+    class _tape
+    {
+        static_assert(std::is_floating_point<value_type>::value);
+
+    public:
+        typedef _tape_node<value_type> node_type;
+
+        _recorded_number<value_type> input(value_type value, value_type tangent = value_type{})
+        {
+            _nodes.push_back(node_type{_tape_op::input, 0, 0, value, tangent});
+            return _recorded_number<value_type>{this, _last()};
+        }
+
+        _recorded_number<value_type> constant(value_type value)
+        {
+            _nodes.push_back(node_type{_tape_op::constant, 0, 0, value, value_type{}});
+            return _recorded_number<value_type>{this, _last()};
+        }
+
+        // unary nodes use lhs for both operands
+        _recorded_number<value_type> push(_tape_op op, size_type lhs)
+        {
+            return push(op, lhs, lhs);
+        }
+
+        _recorded_number<value_type> push(_tape_op op, size_type lhs, size_type rhs)
+        {
+            auto result = _evaluate_tape_op(op, _dual_at(lhs), _dual_at(rhs));
+            _nodes.push_back(node_type{op, lhs, rhs, result.real, result.dual});
+            return _recorded_number<value_type>{this, _last()};
+        }
+
+        bool guard(_tape_op op, size_type lhs, size_type rhs)
+        {
+            return push(op, lhs, rhs).value() != 0.0;
+        }
+
+        void clear() noexcept { _nodes.clear(); }
+
+        size_type size() const noexcept { return static_cast<size_type>(_nodes.size()); }
+        node_type &operator[](size_type i) noexcept { return _nodes[i]; }
+        const node_type &operator[](size_type i) const noexcept { return _nodes[i]; }
+
+    private:
+        size_type _last() const noexcept { return static_cast<size_type>(_nodes.size() - 1); }
+
+        _dual_number<value_type> _dual_at(size_type i) const noexcept
+        {
+            return _dual_number<value_type>{_nodes[i].value, _nodes[i].tangent};
+        }
+
+        std::vector<node_type> _nodes;
+    };
+
+    // handle to a node of a _tape, branch on it only through the comparison operators
+    // so that the tape can tell when the control flow changes
+    template <typename value_type>
+    class _recorded_number
+    {
+    public:
+        _recorded_number(_tape<value_type> *tape, size_type index) : _owner{tape}, _index{index} {}
+
+        size_type index() const noexcept { return _index; }
+        _tape<value_type> *tape() const noexcept { return _owner; }
+        value_type value() const noexcept { return (*_owner)[_index].value; }
+        value_type tangent() const noexcept { return (*_owner)[_index].tangent; }
+
+        friend _recorded_number operator+(const _recorded_number &lhs, const _recorded_number &rhs)
+        {
+            return lhs._owner->push(_tape_op::add, lhs._index, rhs._index);
+        }
+
+        friend _recorded_number operator-(const _recorded_number &lhs, const _recorded_number &rhs)
+        {
+            return lhs._owner->push(_tape_op::sub, lhs._index, rhs._index);
+        }
+
+        friend _recorded_number operator*(const _recorded_number &lhs, const _recorded_number &rhs)
+        {
+            return lhs._owner->push(_tape_op::mul, lhs._index, rhs._index);
+        }
+
+        friend _recorded_number operator/(const _recorded_number &lhs, const _recorded_number &rhs)
+        {
+            return lhs._owner->push(_tape_op::div, lhs._index, rhs._index);
+        }
+
+        friend _recorded_number operator+(const _recorded_number &lhs, value_type rhs) { return lhs + lhs._owner->constant(rhs); }
+        friend _recorded_number operator+(value_type lhs, const _recorded_number &rhs) { return rhs._owner->constant(lhs) + rhs; }
+        friend _recorded_number operator-(const _recorded_number &lhs, value_type rhs) { return lhs - lhs._owner->constant(rhs); }
+        friend _recorded_number operator-(value_type lhs, const _recorded_number &rhs) { return rhs._owner->constant(lhs) - rhs; }
+        friend _recorded_number operator*(const _recorded_number &lhs, value_type rhs) { return lhs * lhs._owner->constant(rhs); }
+        friend _recorded_number operator*(value_type lhs, const _recorded_number &rhs) { return rhs._owner->constant(lhs) * rhs; }
+        friend _recorded_number operator/(const _recorded_number &lhs, value_type rhs) { return lhs / lhs._owner->constant(rhs); }
+        friend _recorded_number operator/(value_type lhs, const _recorded_number &rhs) { return rhs._owner->constant(lhs) / rhs; }
+
+        friend _recorded_number operator-(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::neg, x._index);
+        }
+
+        friend bool operator<(const _recorded_number &lhs, const _recorded_number &rhs)
+        {
+            return lhs._owner->guard(_tape_op::less, lhs._index, rhs._index);
+        }
+
+        friend bool operator<=(const _recorded_number &lhs, const _recorded_number &rhs)
+        {
+            return lhs._owner->guard(_tape_op::less_equal, lhs._index, rhs._index);
+        }
+
+        friend bool operator==(const _recorded_number &lhs, const _recorded_number &rhs)
+        {
+            return lhs._owner->guard(_tape_op::equal, lhs._index, rhs._index);
+        }
+
+        friend bool operator>(const _recorded_number &lhs, const _recorded_number &rhs) { return rhs < lhs; }
+        friend bool operator>=(const _recorded_number &lhs, const _recorded_number &rhs) { return rhs <= lhs; }
+        friend bool operator!=(const _recorded_number &lhs, const _recorded_number &rhs) { return !(lhs == rhs); }
+
+        friend bool operator<(const _recorded_number &lhs, value_type rhs) { return lhs < lhs._owner->constant(rhs); }
+        friend bool operator<(value_type lhs, const _recorded_number &rhs) { return rhs._owner->constant(lhs) < rhs; }
+        friend bool operator<=(const _recorded_number &lhs, value_type rhs) { return lhs <= lhs._owner->constant(rhs); }
+        friend bool operator<=(value_type lhs, const _recorded_number &rhs) { return rhs._owner->constant(lhs) <= rhs; }
+        friend bool operator>(const _recorded_number &lhs, value_type rhs) { return lhs._owner->constant(rhs) < lhs; }
+        friend bool operator>(value_type lhs, const _recorded_number &rhs) { return rhs < rhs._owner->constant(lhs); }
+        friend bool operator>=(const _recorded_number &lhs, value_type rhs) { return lhs._owner->constant(rhs) <= lhs; }
+        friend bool operator>=(value_type lhs, const _recorded_number &rhs) { return rhs <= rhs._owner->constant(lhs); }
+        friend bool operator==(const _recorded_number &lhs, value_type rhs) { return lhs == lhs._owner->constant(rhs); }
+        friend bool operator==(value_type lhs, const _recorded_number &rhs) { return rhs._owner->constant(lhs) == rhs; }
+        friend bool operator!=(const _recorded_number &lhs, value_type rhs) { return !(lhs == rhs); }
+        friend bool operator!=(value_type lhs, const _recorded_number &rhs) { return !(lhs == rhs); }
+
+        // constant exponent
+        friend _recorded_number pow(const _recorded_number &x, value_type p)
+        {
+            return x._owner->push(_tape_op::pow, x._index, x._owner->constant(p)._index);
+        }
+
+        friend _recorded_number abs(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::abs, x._index);
+        }
+
+        friend _recorded_number sq(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::sq, x._index);
+        }
+
+        friend _recorded_number sqrt(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::sqrt, x._index);
+        }
+
+        friend _recorded_number cbrt(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::cbrt, x._index);
+        }
+
+        friend _recorded_number exp(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::exp, x._index);
+        }
+
+        friend _recorded_number log(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::log, x._index);
+        }
+
+        friend _recorded_number sin(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::sin, x._index);
+        }
+
+        friend _recorded_number cos(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::cos, x._index);
+        }
+
+        friend _recorded_number tan(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::tan, x._index);
+        }
+
+        friend _recorded_number asin(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::asin, x._index);
+        }
+
+        friend _recorded_number acos(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::acos, x._index);
+        }
+
+        friend _recorded_number atan(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::atan, x._index);
+        }
+
+        friend _recorded_number sinh(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::sinh, x._index);
+        }
+
+        friend _recorded_number cosh(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::cosh, x._index);
+        }
+
+        friend _recorded_number tanh(const _recorded_number &x)
+        {
+            return x._owner->push(_tape_op::tanh, x._index);
+        }
+
+    private:
+        _tape<value_type> *_owner;
+        size_type _index;
+    };
+#endif // USE_GLOBAL_FLOATING_POINT_TYPE
+} // namespace math::calculus::details
+
+#endif // MATH_CALCULUS_TAPE_HPP
\ No newline at end of file
@@ -7,6 +7,9 @@
 
 // #define USE_GLOBAL_FLOATING_POINT_TYPE
 
+// common instances come from the precompiled library, build with make templates and link build/libMathTemplates.a
+// #define USE_EXTERN_TEMPLATES
+
 namespace math
 {
     typedef double real;
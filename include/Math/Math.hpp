@@ -4,13 +4,15 @@
 #include "Config.hpp"
 
 #if __cplusplus >= 201402L
+#include "Algebra.hpp"
 #include "Calculus.hpp"
+#include "Utility/DoubleDouble.hpp"
 
 #define make_math_function(variable, function) [](auto(variable)) { return (function); }
 
 namespace math
 {
-
+    using utility::double_double;
 } // namespace math
 #endif // c++14
 
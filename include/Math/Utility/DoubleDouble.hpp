@@ -0,0 +1,616 @@
+#ifndef MATH_UTILITY_DOUBLE_DOUBLE_HPP
+#define MATH_UTILITY_DOUBLE_DOUBLE_HPP
+
+#include "Config.hpp"
+
+#include "Utility/ScalarTraits.hpp"
+
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace math::utility
+{
+    // unevaluated sum high + low with |low| <= ulp(high) / 2, 106 bits or about 31 decimal digits
+    // (Hida, Li and Bailey, Algorithms for quad-double precision floating point arithmetic);
+    // the error free products use std::fma, which is a single instruction when built with -mfma or -march=native
+    class double_double
+    {
+    public:
+        constexpr double_double(double high = 0.0, double low = 0.0) noexcept : _high{high}, _low{low} {}
+
+        constexpr double high() const noexcept { return _high; }
+        constexpr double low() const noexcept { return _low; }
+
+        // rounds to the nearest double, high already is
+        explicit constexpr operator double() const noexcept { return _high; }
+
+        static constexpr double_double pi() noexcept { return {3.141592653589793116e+00, 1.224646799147353207e-16}; }
+        static constexpr double_double ln2() noexcept { return {6.931471805599452862e-01, 2.319046813846299558e-17}; }
+        static constexpr double_double ln10() noexcept { return {2.302585092994045901e+00, -2.170756223382249351e-16}; }
+
+        // 32 significant digits by default, scientific notation
+        std::string to_string(int digits = 32) const
+        {
+            if (std::isnan(_high))
+                return "nan";
+            if (std::isinf(_high))
+                return _high < 0.0 ? "-inf" : "inf";
+            std::string result = _high < 0.0 ? "-" : "";
+            if (_high == 0.0)
+                return result + "0";
+            digits = digits < 1 ? 1 : digits;
+
+            double_double r = fabs(*this);
+            int exponent = static_cast<int>(std::floor(std::log10(r._high)));
+            r = exponent < 0 ? r * _power_of_ten(-exponent) : r / _power_of_ten(exponent);
+            if (r >= 10.0)
+            {
+                r /= 10.0;
+                ++exponent;
+            }
+            if (r < 1.0)
+            {
+                r *= 10.0;
+                --exponent;
+            }
+
+            // one guard digit for rounding, a digit may come out as -1 or 10 and is carried afterwards
+            std::vector<int> value(digits + 1);
+            for (int i = 0; i <= digits; ++i)
+            {
+                value[i] = static_cast<int>(std::floor(r._high));
+                r = (r - static_cast<double>(value[i])) * 10.0;
+            }
+            if (value[digits] >= 5)
+                ++value[digits - 1];
+            for (int i = digits - 1; i > 0; --i)
+            {
+                if (value[i] > 9)
+                {
+                    value[i] -= 10;
+                    ++value[i - 1];
+                }
+                else if (value[i] < 0)
+                {
+                    value[i] += 10;
+                    --value[i - 1];
+                }
+            }
+            if (value[0] > 9)
+            {
+                for (int i = digits - 1; i > 0; --i)
+                    value[i] = value[i - 1];
+                value[0] = 1;
+                value[1] = 0;
+                ++exponent;
+            }
+
+            result += static_cast<char>('0' + value[0]);
+            if (digits > 1)
+                result += '.';
+            for (int i = 1; i < digits; ++i)
+                result += static_cast<char>('0' + value[i]);
+            return result + (exponent < 0 ? "e-" : "e+") + std::to_string(exponent < 0 ? -exponent : exponent);
+        }
+
+        double_double &operator+=(const double_double &rhs) noexcept { return *this = *this + rhs; }
+        double_double &operator+=(double rhs) noexcept { return *this = *this + rhs; }
+        double_double &operator-=(const double_double &rhs) noexcept { return *this = *this - rhs; }
+        double_double &operator-=(double rhs) noexcept { return *this = *this - rhs; }
+        double_double &operator*=(const double_double &rhs) noexcept { return *this = *this * rhs; }
+        double_double &operator*=(double rhs) noexcept { return *this = *this * rhs; }
+        double_double &operator/=(const double_double &rhs) noexcept { return *this = *this / rhs; }
+        double_double &operator/=(double rhs) noexcept { return *this = *this / rhs; }
+
+        double_double operator-() const noexcept { return {-_high, -_low}; }
+
+        // both low parts are summed with their own error, so cancelling high parts keep full precision;
+        // the error-free transforms return a zero low part once the rounded high part is not finite,
+        // so an overflow or an infinite operand gives the IEEE infinity instead of inf - inf
+        friend double_double operator+(const double_double &lhs, const double_double &rhs) noexcept
+        {
+            double_double high = _two_sum(lhs._high, rhs._high), low = _two_sum(lhs._low, rhs._low);
+            high = _quick_two_sum(high._high, high._low + low._high);
+            return _quick_two_sum(high._high, high._low + low._low);
+        }
+
+        friend double_double operator+(const double_double &lhs, double rhs) noexcept
+        {
+            double_double sum = _two_sum(lhs._high, rhs);
+            return _quick_two_sum(sum._high, sum._low + lhs._low);
+        }
+
+        friend double_double operator+(double lhs, const double_double &rhs) noexcept { return rhs + lhs; }
+
+        friend double_double operator-(const double_double &lhs, const double_double &rhs) noexcept { return lhs + -rhs; }
+        friend double_double operator-(const double_double &lhs, double rhs) noexcept { return lhs + -rhs; }
+        friend double_double operator-(double lhs, const double_double &rhs) noexcept { return -rhs + lhs; }
+
+        friend double_double operator*(const double_double &lhs, const double_double &rhs) noexcept
+        {
+            double_double product = _two_product(lhs._high, rhs._high);
+            if (!std::isfinite(product._high))
+                return product;
+            return _quick_two_sum(product._high, product._low + (lhs._high * rhs._low + lhs._low * rhs._high));
+        }
+
+        friend double_double operator*(const double_double &lhs, double rhs) noexcept
+        {
+            double_double product = _two_product(lhs._high, rhs);
+            if (!std::isfinite(product._high))
+                return product;
+            return _quick_two_sum(product._high, product._low + lhs._low * rhs);
+        }
+
+        friend double_double operator*(double lhs, const double_double &rhs) noexcept { return rhs * lhs; }
+
+        // long division with three double quotient digits, a zero or non-finite divisor or quotient
+        // is left to the double division so that it gives the IEEE infinities and zeros
+        friend double_double operator/(const double_double &lhs, const double_double &rhs) noexcept
+        {
+            double q1 = lhs._high / rhs._high;
+            if (!std::isfinite(q1) || !std::isfinite(rhs._high) || rhs._high == 0.0)
+                return q1;
+            double_double r = lhs - rhs * q1;
+            double q2 = r._high / rhs._high;
+            r -= rhs * q2;
+            double q3 = r._high / rhs._high;
+            return _quick_two_sum(q1, q2) + q3;
+        }
+
+        friend double_double operator/(const double_double &lhs, double rhs) noexcept
+        {
+            double q1 = lhs._high / rhs;
+            if (!std::isfinite(q1) || !std::isfinite(rhs) || rhs == 0.0)
+                return q1;
+            double_double product = _two_product(q1, rhs);
+            double_double difference = _two_sum(lhs._high, -product._high);
+            double q2 = (difference._high + (difference._low - product._low + lhs._low)) / rhs;
+            return _quick_two_sum(q1, q2);
+        }
+
+        friend double_double operator/(double lhs, const double_double &rhs) noexcept { return double_double{lhs} / rhs; }
+
+        // doubles convert implicitly, so these cover the mixed comparisons as well
+        friend bool operator==(const double_double &lhs, const double_double &rhs) noexcept
+        {
+            return lhs._high == rhs._high && lhs._low == rhs._low;
+        }
+
+        friend bool operator!=(const double_double &lhs, const double_double &rhs) noexcept { return !(lhs == rhs); }
+
+        friend bool operator<(const double_double &lhs, const double_double &rhs) noexcept
+        {
+            return lhs._high < rhs._high || (lhs._high == rhs._high && lhs._low < rhs._low);
+        }
+
+        friend bool operator>(const double_double &lhs, const double_double &rhs) noexcept { return rhs < lhs; }
+        friend bool operator<=(const double_double &lhs, const double_double &rhs) noexcept { return !(rhs < lhs); }
+        friend bool operator>=(const double_double &lhs, const double_double &rhs) noexcept { return !(lhs < rhs); }
+
+        friend std::ostream &operator<<(std::ostream &os, const double_double &x)
+        {
+            return os << x.to_string(static_cast<int>(os.precision()));
+        }
+
+        // classification and rounding group
+
+        friend bool isnan(const double_double &x) noexcept { return std::isnan(x._high) || std::isnan(x._low); }
+        friend bool isinf(const double_double &x) noexcept { return std::isinf(x._high); }
+        friend bool isfinite(const double_double &x) noexcept { return std::isfinite(x._high); }
+
+        friend double_double abs(const double_double &x) noexcept { return x._high < 0.0 ? -x : x; }
+        friend double_double fabs(const double_double &x) noexcept { return abs(x); }
+
+        friend double_double floor(const double_double &x) noexcept
+        {
+            double high = std::floor(x._high);
+            return high == x._high ? _quick_two_sum(high, std::floor(x._low)) : double_double{high};
+        }
+
+        friend double_double ceil(const double_double &x) noexcept
+        {
+            double high = std::ceil(x._high);
+            return high == x._high ? _quick_two_sum(high, std::ceil(x._low)) : double_double{high};
+        }
+
+        friend double_double ldexp(const double_double &x, int exponent) noexcept
+        {
+            return {std::ldexp(x._high, exponent), std::ldexp(x._low, exponent)};
+        }
+
+        // ties take x, a NaN operand yields the other one as in std::fmin
+        friend double_double fmin(const double_double &x, const double_double &y) noexcept
+        {
+            return (y < x || isnan(x)) ? y : x;
+        }
+
+        friend double_double fmax(const double_double &x, const double_double &y) noexcept
+        {
+            return (y > x || isnan(x)) ? y : x;
+        }
+
+        friend double_double fma(const double_double &x, const double_double &y, const double_double &z) noexcept
+        {
+            return x * y + z;
+        }
+
+        // power group
+
+        // one Newton step on 1 / sqrt(x) from the double estimate (Karp and Markstein)
+        friend double_double sqrt(const double_double &x) noexcept
+        {
+            if (x._high <= 0.0 || std::isinf(x._high))
+                return x._high == 0.0 || x._high > 0.0 ? x : double_double{std::numeric_limits<double>::quiet_NaN()};
+            double inverse = 1.0 / std::sqrt(x._high), root = x._high * inverse;
+            double_double residual = x - _two_product(root, root);
+            return _two_sum(root, residual._high * (inverse * 0.5));
+        }
+
+        friend double_double cbrt(const double_double &x) noexcept
+        {
+            if (x._high == 0.0 || !std::isfinite(x._high))
+                return x;
+            double_double root{std::cbrt(x._high)};
+            return root - (root * root * root - x) / (3.0 * root * root);
+        }
+
+        // sqrt(x^2 + y^2) scaled by a power of two against overflow
+        friend double_double hypot(const double_double &x, const double_double &y) noexcept
+        {
+            double largest = std::fmax(std::fabs(x._high), std::fabs(y._high));
+            if (largest == 0.0 || !std::isfinite(largest))
+                return double_double{largest};
+            int exponent;
+            std::frexp(largest, &exponent);
+            double_double u = ldexp(x, -exponent), v = ldexp(y, -exponent);
+            return ldexp(sqrt(u * u + v * v), exponent);
+        }
+
+        // integral y by repeated squaring, so negative x is fine there, otherwise exp(y * log(x)) for x > 0
+        friend double_double pow(const double_double &x, const double_double &y) noexcept
+        {
+            if (y == 0.0)
+                return 1.0;
+            if (floor(y) == y && std::fabs(y._high) < 1073741824.0)
+            {
+                long n = static_cast<long>(y._high) + static_cast<long>(y._low);
+                double_double result = _integer_power(x, n < 0 ? -n : n);
+                return n < 0 ? 1.0 / result : result;
+            }
+            if (x._high == 0.0)
+                return y._high > 0.0 ? 0.0 : std::numeric_limits<double>::infinity();
+            if (x._high < 0.0)
+                return std::numeric_limits<double>::quiet_NaN();
+            return exp(y * log(x));
+        }
+
+        // exponential and logarithmic group
+
+        // x = m ln2 + 512 r, e^(512 r) by nine squarings of e^r - 1 from its Taylor series
+        friend double_double exp(const double_double &x) noexcept
+        {
+            if (x._high > 709.78)
+                return std::numeric_limits<double>::infinity();
+            if (x._high < -745.2)
+                return 0.0;
+            if (x._high == 0.0)
+                return 1.0;
+            double m = std::floor(x._high / ln2()._high + 0.5);
+            double_double r = ldexp(_reduce(x, m, ln2(), 5.707708438416212066e-34), -9);
+            double_double s = _expm1_series(r);
+            for (int i = 0; i < 9; ++i)
+                s = 2.0 * s + s * s;
+            return ldexp(s + 1.0, static_cast<int>(m));
+        }
+
+        friend double_double expm1(const double_double &x) noexcept
+        {
+            return std::fabs(x._high) < 0.5 ? _expm1_series(x) : exp(x) - 1.0;
+        }
+
+        friend double_double exp2(const double_double &x) noexcept { return exp(x * ln2()); }
+
+        // x = 2^e m with m in [sqrt(1/2), sqrt(2)) and log m = 2 atanh((m - 1) / (m + 1)), whose series
+        // converges by a factor of 34 per term and keeps its relative accuracy for m near 1
+        friend double_double log(const double_double &x) noexcept
+        {
+            if (x._high <= 0.0)
+                return x._high == 0.0 ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+            if (std::isinf(x._high) || std::isnan(x._high))
+                return x;
+            if (x == 1.0)
+                return 0.0;
+            int e;
+            std::frexp(x._high, &e);
+            double_double m = ldexp(x, -e);
+            if (m._high < 0.7071067811865476)
+            {
+                m = ldexp(m, 1);
+                --e;
+            }
+            double_double y = 2.0 * _atanh_series((m - 1.0) / (m + 1.0));
+            return e == 0 ? y : ln2() * static_cast<double>(e) + y;
+        }
+
+        // 2 atanh(x / (2 + x)) keeps small x exact where log(1 + x) would round 1 + x
+        friend double_double log1p(const double_double &x) noexcept
+        {
+            if (std::fabs(x._high) >= 0.25)
+                return log(1.0 + x);
+            return 2.0 * _atanh_series(x / (2.0 + x));
+        }
+
+        friend double_double log2(const double_double &x) noexcept { return log(x) / ln2(); }
+        friend double_double log10(const double_double &x) noexcept { return log(x) / ln10(); }
+
+        // trigonometric group
+        // arguments are reduced by pi / 2 carried to three doubles, which stays accurate to about |x| = 2^40
+
+        friend double_double sin(const double_double &x) noexcept
+        {
+            double_double s, c;
+            _sin_cos(x, s, c);
+            return s;
+        }
+
+        friend double_double cos(const double_double &x) noexcept
+        {
+            double_double s, c;
+            _sin_cos(x, s, c);
+            return c;
+        }
+
+        friend double_double tan(const double_double &x) noexcept
+        {
+            double_double s, c;
+            _sin_cos(x, s, c);
+            return s / c;
+        }
+
+        // one Newton step on sin(z) = y / r or cos(z) = x / r from the double angle, whichever is better conditioned
+        friend double_double atan2(const double_double &y, const double_double &x) noexcept
+        {
+            if (x._high == 0.0 && y._high == 0.0)
+                return double_double{std::atan2(y._high, x._high)};
+            double largest = std::fmax(std::fabs(x._high), std::fabs(y._high));
+            int exponent;
+            std::frexp(largest, &exponent);
+            double_double u = ldexp(x, -exponent), v = ldexp(y, -exponent), r = sqrt(u * u + v * v);
+            u /= r;
+            v /= r;
+            double_double z{std::atan2(y._high, x._high)}, s, c;
+            _sin_cos(z, s, c);
+            if (std::fabs(u._high) > std::fabs(v._high))
+                return z + (v - s) / c;
+            return z - (u - c) / s;
+        }
+
+        friend double_double atan(const double_double &x) noexcept { return atan2(x, 1.0); }
+
+        friend double_double asin(const double_double &x) noexcept
+        {
+            if (std::fabs(x._high) > 1.0)
+                return std::numeric_limits<double>::quiet_NaN();
+            return atan2(x, sqrt((1.0 - x) * (1.0 + x)));
+        }
+
+        friend double_double acos(const double_double &x) noexcept
+        {
+            if (std::fabs(x._high) > 1.0)
+                return std::numeric_limits<double>::quiet_NaN();
+            return atan2(sqrt((1.0 - x) * (1.0 + x)), x);
+        }
+
+        // hyperbolic group
+
+        friend double_double sinh(const double_double &x) noexcept
+        {
+            if (std::fabs(x._high) < 0.5)
+            {
+                double_double x_sq = x * x, term = x, sum = x;
+                for (int k = 2; std::fabs(term._high) > _epsilon * std::fabs(sum._high); k += 2)
+                {
+                    term *= x_sq / static_cast<double>(k * (k + 1));
+                    sum += term;
+                }
+                return sum;
+            }
+            double_double e = exp(x);
+            return 0.5 * (e - 1.0 / e);
+        }
+
+        friend double_double cosh(const double_double &x) noexcept
+        {
+            double_double e = exp(x);
+            return 0.5 * (e + 1.0 / e);
+        }
+
+        friend double_double tanh(const double_double &x) noexcept
+        {
+            if (std::fabs(x._high) > 40.0)
+                return x._high > 0.0 ? 1.0 : -1.0;
+            double_double s = sinh(x);
+            return s / sqrt(1.0 + s * s);
+        }
+
+        friend double_double asinh(const double_double &x) noexcept
+        {
+            double_double a = abs(x), a_sq = a * a;
+            double_double result = log1p(a + a_sq / (1.0 + sqrt(1.0 + a_sq)));
+            return x._high < 0.0 ? -result : result;
+        }
+
+        // log1p(t + sqrt(2t + t^2)) with t = x - 1 >= 0
+        friend double_double acosh(const double_double &x) noexcept
+        {
+            if (x._high < 1.0)
+                return std::numeric_limits<double>::quiet_NaN();
+            double_double t = x - 1.0;
+            return log1p(t + sqrt(t * (2.0 + t)));
+        }
+
+        friend double_double atanh(const double_double &x) noexcept
+        {
+            if (std::fabs(x._high) > 1.0)
+                return std::numeric_limits<double>::quiet_NaN();
+            return 0.5 * log1p(2.0 * x / (1.0 - x));
+        }
+
+    private:
+        // 2^-104, the relative rounding error of one operation
+        static constexpr double _epsilon = 4.93038065763132e-32;
+
+        // a + b exactly as high + low
+        static double_double _two_sum(double a, double b) noexcept
+        {
+            double s = a + b;
+            if (!std::isfinite(s))
+                return {s, 0.0};
+            double v = s - a;
+            return {s, (a - (s - v)) + (b - v)};
+        }
+
+        // the same for |a| >= |b|
+        static double_double _quick_two_sum(double a, double b) noexcept
+        {
+            double s = a + b;
+            if (!std::isfinite(s))
+                return {s, 0.0};
+            return {s, b - (s - a)};
+        }
+
+        static double_double _two_product(double a, double b) noexcept
+        {
+            double p = a * b;
+            if (!std::isfinite(p))
+                return {p, 0.0};
+            return {p, std::fma(a, b, -p)};
+        }
+
+        static double_double _integer_power(double_double x, unsigned long n) noexcept
+        {
+            double_double result{1.0};
+            for (; n > 0; n >>= 1, x *= x)
+                if (n & 1)
+                    result *= x;
+            return result;
+        }
+
+        static double_double _power_of_ten(int n) noexcept { return _integer_power(10.0, static_cast<unsigned long>(n)); }
+
+        // atanh u = u + u^3 / 3 + u^5 / 5 + ... for small u
+        static double_double _atanh_series(const double_double &u) noexcept
+        {
+            double_double u_sq = u * u, term = u, sum = u;
+            for (int k = 3; std::fabs(term._high) > _epsilon * std::fabs(sum._high); k += 2)
+            {
+                term *= u_sq;
+                sum += term / static_cast<double>(k);
+            }
+            return sum;
+        }
+
+        // e^x - 1 = x + x^2 / 2! + ... for small x
+        static double_double _expm1_series(const double_double &x) noexcept
+        {
+            double_double term = x, sum = x;
+            for (int k = 2; std::fabs(term._high) > _epsilon * std::fabs(sum._high); ++k)
+            {
+                term = term * x / static_cast<double>(k);
+                sum += term;
+            }
+            return sum;
+        }
+
+        // x - j * (period + tail) with the two products of the double-double period exact and a third term
+        // of the constant, so the reduced argument stays accurate where it cancels against x
+        static double_double _reduce(const double_double &x, double j, const double_double &period, double tail) noexcept
+        {
+            return ((x - _two_product(period._high, j)) - _two_product(period._low, j)) - tail * j;
+        }
+
+        // x = j pi / 2 + t with |t| <= pi / 4, then the Taylor series of sin t and cos t
+        static void _sin_cos(const double_double &x, double_double &s, double_double &c) noexcept
+        {
+            const double_double half_pi{1.570796326794896558e+00, 6.123233995736766036e-17};
+            double j = std::floor(x._high / half_pi._high + 0.5);
+            double_double t = _reduce(x, j, half_pi, -1.497384904859169833e-33), t_sq = t * t;
+
+            double_double sin_term = t, sin_t = t, cos_term = 1.0, cos_t = 1.0;
+            for (int k = 1; std::fabs(sin_term._high) > _epsilon * 1e-2 || std::fabs(cos_term._high) > _epsilon * 1e-2; ++k)
+            {
+                cos_term *= -t_sq / static_cast<double>((2 * k - 1) * (2 * k));
+                sin_term *= -t_sq / static_cast<double>((2 * k) * (2 * k + 1));
+                cos_t += cos_term;
+                sin_t += sin_term;
+            }
+
+            switch (static_cast<long long>(std::fmod(j, 4.0) + 4.0) % 4)
+            {
+            case 0:
+                s = sin_t;
+                c = cos_t;
+                break;
+            case 1:
+                s = cos_t;
+                c = -sin_t;
+                break;
+            case 2:
+                s = -sin_t;
+                c = -cos_t;
+                break;
+            default:
+                s = -cos_t;
+                c = sin_t;
+                break;
+            }
+        }
+
+        double _high;
+        double _low;
+    };
+
+    template <>
+    struct scalar_traits<double_double>
+    {
+        static constexpr bool is_scalar = true;
+    };
+} // namespace math::utility
+
+namespace std
+{
+    template <>
+    class numeric_limits<math::utility::double_double>
+    {
+        typedef math::utility::double_double type;
+
+    public:
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = true;
+        static constexpr bool is_integer = false;
+        static constexpr bool is_exact = false;
+        static constexpr bool has_infinity = true;
+        static constexpr bool has_quiet_NaN = true;
+        static constexpr int radix = 2;
+        static constexpr int digits = 106;
+        static constexpr int digits10 = 31;
+        static constexpr int max_digits10 = 33;
+        static constexpr int min_exponent = numeric_limits<double>::min_exponent + 53;
+        static constexpr int max_exponent = numeric_limits<double>::max_exponent;
+
+        // the smallest value whose low part is still normal
+        static constexpr type min() noexcept { return type{2.0041683600089728e-292}; }
+        static constexpr type max() noexcept { return type{1.79769313486231570815e+308, 9.97920154767359795037e+291}; }
+        static constexpr type lowest() noexcept { return type{-1.79769313486231570815e+308, -9.97920154767359795037e+291}; }
+        static constexpr type epsilon() noexcept { return type{4.93038065763132e-32}; }
+        static constexpr type round_error() noexcept { return type{0.5}; }
+        static constexpr type infinity() noexcept { return type{numeric_limits<double>::infinity()}; }
+        static constexpr type quiet_NaN() noexcept { return type{numeric_limits<double>::quiet_NaN()}; }
+    };
+} // namespace std
+
+#endif // MATH_UTILITY_DOUBLE_DOUBLE_HPP
@@ -0,0 +1,83 @@
+#ifndef MATH_UTILITY_PARALLEL_HPP
+#define MATH_UTILITY_PARALLEL_HPP
+
+#include "Config.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace math::utility
+{
+    // 0 means one thread per hardware thread
+    inline size_type thread_count(size_type requested = 0) noexcept
+    {
+        if (requested != 0)
+            return requested;
+        size_type hardware = std::thread::hardware_concurrency();
+        return hardware == 0 ? 1 : hardware;
+    }
+
+    // splits [0, count) into at most threads contiguous ranges and calls f(begin, end) on each,
+    // the calling thread takes the first range and every other range gets its own copy of f on a new thread,
+    // so each range should carry enough work to pay for starting one; the first exception thrown by any
+    // range is rethrown once all of them have finished, and a range whose thread cannot start runs inline
+    template <typename func_tp>
+    void parallel_for(size_type count, size_type threads, func_tp f)
+    {
+        threads = std::min(thread_count(threads), count);
+        if (threads <= 1)
+        {
+            if (count != 0)
+                f(size_type{0}, count);
+            return;
+        }
+
+        std::exception_ptr failure;
+        std::mutex failure_mutex;
+        auto run = [&failure, &failure_mutex](func_tp &body, size_type begin, size_type end)
+        {
+            try
+            {
+                body(begin, end);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock{failure_mutex};
+                if (!failure)
+                    failure = std::current_exception();
+            }
+        };
+
+        size_type chunk = count / threads;
+        size_type remainder = count % threads;
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+
+        size_type begin = chunk + (remainder != 0);
+        for (size_type t = 1; t < threads; ++t)
+        {
+            size_type end = begin + chunk + (t < remainder);
+            try
+            {
+                workers.emplace_back([run, f, begin, end]() mutable { run(f, begin, end); });
+            }
+            catch (const std::system_error &)
+            {
+                run(f, begin, end);
+            }
+            begin = end;
+        }
+        run(f, size_type{0}, chunk + (remainder != 0));
+
+        for (auto &worker : workers)
+            worker.join();
+        if (failure)
+            std::rethrow_exception(failure);
+    }
+} // namespace math::utility
+
+#endif // MATH_UTILITY_PARALLEL_HPP
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef MATH_UTILITY_PHILOX_HPP
+#define MATH_UTILITY_PHILOX_HPP
+
+#include "Config.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace math::utility
+{
+    // Philox4x32-10 (Salmon et al., Parallel random numbers: as easy as 1, 2, 3),
+    // a keyed bijection of 128-bit counters: the n-th block of any stream is computed directly,
+    // so streams need no state to be shared or skipped ahead between threads
+    class philox4x32
+    {
+    public:
+        typedef std::array<std::uint32_t, 4> counter_type;
+
+        explicit philox4x32(std::uint64_t key) noexcept
+            : _key{static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)} {}
+
+        counter_type operator()(counter_type counter) const noexcept
+        {
+            std::uint32_t k0 = _key[0], k1 = _key[1];
+            for (int round = 0; round < 10; ++round)
+            {
+                std::uint64_t p0 = std::uint64_t{0xD2511F53} * counter[0];
+                std::uint64_t p1 = std::uint64_t{0xCD9E8D57} * counter[2];
+                counter = {static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ k0,
+                           static_cast<std::uint32_t>(p1),
+                           static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ k1,
+                           static_cast<std::uint32_t>(p0)};
+                k0 += 0x9E3779B9;
+                k1 += 0xBB67AE85;
+            }
+            return counter;
+        }
+
+    private:
+        std::array<std::uint32_t, 2> _key;
+    };
+
+    // stream number stream of seed, the counter is (draw block, stream),
+    // so every stream yields 2^64 blocks of four words independent of all others
+    template <typename value_type = math::real>
+    class philox_stream
+    {
+        static_assert(std::is_floating_point<value_type>::value, "philox_stream needs a floating point type");
+
+    public:
+        philox_stream(std::uint64_t seed, std::uint64_t stream) noexcept
+            : _generator{seed}, _stream{stream} {}
+
+        std::uint32_t next() noexcept
+        {
+            if (_position == 4)
+            {
+                _words = _generator({static_cast<std::uint32_t>(_block), static_cast<std::uint32_t>(_block >> 32),
+                                     static_cast<std::uint32_t>(_stream), static_cast<std::uint32_t>(_stream >> 32)});
+                ++_block;
+                _position = 0;
+            }
+            return _words[_position++];
+        }
+
+        // uniform on the open interval (0, 1), 53 random bits for double and 24 for float
+        value_type uniform() noexcept
+        {
+            if (std::numeric_limits<value_type>::digits > 32)
+            {
+                std::uint64_t high = next();
+                std::uint64_t bits = (high << 21) | (next() >> 11);
+                return (static_cast<value_type>(bits) + 0.5) * static_cast<value_type>(1.0 / 9007199254740992.0);
+            }
+            return (static_cast<value_type>(next() >> 8) + 0.5f) * static_cast<value_type>(1.0 / 16777216.0);
+        }
+
+        // standard normal by Box-Muller, the second value of a pair is kept for the next call
+        value_type normal() noexcept
+        {
+            if (_has_spare)
+            {
+                _has_spare = false;
+                return _spare;
+            }
+            value_type radius = std::sqrt(-2.0 * std::log(uniform()));
+            value_type angle = static_cast<value_type>(6.283185307179586476925) * uniform();
+            _spare = radius * std::sin(angle);
+            _has_spare = true;
+            return radius * std::cos(angle);
+        }
+
+    private:
+        philox4x32 _generator;
+        std::uint64_t _stream;
+        std::uint64_t _block = 0;
+        philox4x32::counter_type _words{};
+        size_type _position = 4;
+        value_type _spare = 0.0;
+        bool _has_spare = false;
+    };
+} // namespace math::utility
+
+#endif // MATH_UTILITY_PHILOX_HPP
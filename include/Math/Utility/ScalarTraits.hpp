@@ -0,0 +1,60 @@
+#ifndef MATH_UTILITY_SCALAR_TRAITS_HPP
+#define MATH_UTILITY_SCALAR_TRAITS_HPP
+
+#include "Config.hpp"
+
+#include <cmath>
+#include <type_traits>
+
+namespace math
+{
+    namespace utility
+    {
+        // value types accepted by the automatic differentiation types: the built-in floating point types,
+        // and any type that specializes this with is_scalar = true and supplies arithmetic with double,
+        // comparisons, an explicit conversion to double and the elementary functions next to itself
+        template <typename value_type>
+        struct scalar_traits
+        {
+            static constexpr bool is_scalar = std::is_floating_point<value_type>::value;
+        };
+    } // namespace math::utility
+
+    // the elementary functions are called unqualified on value types: these supply them for the built-in
+    // types and argument dependent lookup finds those of other scalars; code written for dual numbers also
+    // runs on the inactive arguments that first_order_derivative<pos> passes as plain values
+    using std::abs;
+    using std::acos;
+    using std::acosh;
+    using std::asin;
+    using std::asinh;
+    using std::atan;
+    using std::atan2;
+    using std::atanh;
+    using std::cbrt;
+    using std::ceil;
+    using std::cos;
+    using std::cosh;
+    using std::exp;
+    using std::expm1;
+    using std::fabs;
+    using std::floor;
+    using std::fma;
+    using std::fmax;
+    using std::fmin;
+    using std::hypot;
+    using std::isfinite;
+    using std::isinf;
+    using std::isnan;
+    using std::ldexp;
+    using std::log;
+    using std::log1p;
+    using std::pow;
+    using std::sin;
+    using std::sinh;
+    using std::sqrt;
+    using std::tan;
+    using std::tanh;
+} // namespace math
+
+#endif // MATH_UTILITY_SCALAR_TRAITS_HPP